@@ -73,17 +73,38 @@ function(boost_modular_build)
         file(WRITE ${_bm_SOURCE_PATH}/build/Jamfile.v2 "${_contents}")
     endif()
 
-    function(unix_build BOOST_LIB_SUFFIX BUILD_TYPE BUILD_LIB_PATH)
-        message(STATUS "Building ${BUILD_TYPE}...")
-        set(BOOST_LIB_SUFFIX ${BOOST_LIB_SUFFIX})
-        set(VARIANT ${BUILD_TYPE})
-        set(BUILD_LIB_PATH ${BUILD_LIB_PATH})
-        configure_file(${_bm_DIR}/Jamroot.jam ${_bm_SOURCE_PATH}/Jamroot.jam @ONLY)
+    set(B2_VARIANTS)
+    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "release")
+        list(APPEND B2_VARIANTS release)
+    endif()
+    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
+        list(APPEND B2_VARIANTS debug)
+    endif()
+
+    # A single run of b2 builds all variants in parallel, and reads the Jamfiles only once.
+    # Variables (-s...) apply to the whole run, and b2 looks for the compression libraries of boost-iostreams
+    # only once per run, so these need a run per variant.
+    set(BUILD_VARIANTS_SEPARATELY OFF)
+    if(PORT STREQUAL "boost-iostreams")
+        set(BUILD_VARIANTS_SEPARATELY ON)
+    endif()
+    foreach(OPTION IN LISTS B2_OPTIONS_REL B2_OPTIONS_DBG)
+        if(OPTION MATCHES "^-")
+            set(BUILD_VARIANTS_SEPARATELY ON)
+        endif()
+    endforeach()
 
+    if(VCPKG_CMAKE_SYSTEM_NAME AND NOT VCPKG_CMAKE_SYSTEM_NAME STREQUAL "WindowsStore")
         set(configure_option)
         if(DEFINED _bm_BOOST_CMAKE_FRAGMENT)
             list(APPEND configure_option "-DBOOST_CMAKE_FRAGMENT=${_bm_BOOST_CMAKE_FRAGMENT}")
         endif()
+        if(NOT BUILD_VARIANTS_SEPARATELY)
+            # The release configuration runs b2 for all variants.
+            list(JOIN B2_VARIANTS "," B2_VARIANTS)
+            list(APPEND configure_option "-DB2_VARIANTS=${B2_VARIANTS}")
+            set(VCPKG_BUILD_TYPE release)
+        endif()
         vcpkg_configure_cmake(
             SOURCE_PATH ${BOOST_BUILD_INSTALLED_DIR}/share/boost-build
             PREFER_NINJA
@@ -94,29 +115,12 @@ function(boost_modular_build)
                 "-DB2_EXE=${B2_EXE}"
                 "-DSOURCE_PATH=${_bm_SOURCE_PATH}"
                 "-DBOOST_BUILD_PATH=${BOOST_BUILD_PATH}"
+                "-DBOOST_LIB_PREFIX=${BOOST_LIB_PREFIX}"
+                "-DBOOST_LIB_RELEASE_SUFFIX=${BOOST_LIB_RELEASE_SUFFIX}"
+                "-DBOOST_LIB_DEBUG_SUFFIX=${BOOST_LIB_DEBUG_SUFFIX}"
                 ${configure_option}
         )
         vcpkg_install_cmake()
-    endfunction()
-
-    if(VCPKG_CMAKE_SYSTEM_NAME AND NOT VCPKG_CMAKE_SYSTEM_NAME STREQUAL "WindowsStore")
-        set(build_flag 0)
-        if(NOT DEFINED VCPKG_BUILD_TYPE)
-            set(build_flag 1)
-            set(VCPKG_BUILD_TYPE "release")
-        endif()
-
-        if(VCPKG_BUILD_TYPE STREQUAL "release")
-            unix_build(${BOOST_LIB_RELEASE_SUFFIX} "release" "lib/")
-        endif()
-
-        if(build_flag)
-            set(VCPKG_BUILD_TYPE "debug")
-        endif()
-
-        if(VCPKG_BUILD_TYPE STREQUAL "debug")
-            unix_build(${BOOST_LIB_DEBUG_SUFFIX} "debug" "debug/lib/")
-        endif()
 
         if(NOT EXISTS ${CURRENT_PACKAGES_DIR}/lib)
             message(FATAL_ERROR "No libraries were produced. This indicates a failure while building the boost library.")
@@ -129,33 +133,27 @@ function(boost_modular_build)
     #####################
     # Cleanup previous builds
     ######################
-    file(REMOVE_RECURSE ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel)
-    if(EXISTS ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel)
-        # It is possible for a file in this folder to be locked due to antivirus or vctip
-        execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
-        file(REMOVE_RECURSE ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel)
-        if(EXISTS ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel)
-            message(FATAL_ERROR "Unable to remove directory: ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel\n  Files are likely in use.")
-        endif()
-    endif()
-
-    file(REMOVE_RECURSE ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
-    if(EXISTS ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
-        # It is possible for a file in this folder to be locked due to antivirus or vctip
-        execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
-        file(REMOVE_RECURSE ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
-        if(EXISTS ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
-            message(FATAL_ERROR "Unable to remove directory: ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg\n  Files are likely in use.")
+    if(BUILD_VARIANTS_SEPARATELY)
+        set(BUILD_DIR_REL ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel)
+        set(BUILD_DIR_DBG ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg)
+    else()
+        set(BUILD_DIR_REL ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET})
+        set(BUILD_DIR_DBG ${BUILD_DIR_REL})
+    endif()
+    set(BUILD_DIRS ${BUILD_DIR_REL} ${BUILD_DIR_DBG})
+    list(REMOVE_DUPLICATES BUILD_DIRS)
+    foreach(BUILD_DIR IN LISTS BUILD_DIRS)
+        file(REMOVE_RECURSE ${BUILD_DIR})
+        if(EXISTS ${BUILD_DIR})
+            # It is possible for a file in this folder to be locked due to antivirus or vctip
+            message(FATAL_ERROR "Unable to remove directory: ${BUILD_DIR}\n  Files are likely in use.")
         endif()
-    endif()
+        file(MAKE_DIRECTORY ${BUILD_DIR})
+    endforeach()
 
     if(EXISTS ${CURRENT_PACKAGES_DIR}/debug)
         message(FATAL_ERROR "Error: directory exists: ${CURRENT_PACKAGES_DIR}/debug\n  The previous package was not fully cleared. This is an internal error.")
     endif()
-    file(MAKE_DIRECTORY
-        ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg
-        ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel
-    )
 
     include(ProcessorCount)
     ProcessorCount(NUMBER_OF_PROCESSORS)
@@ -186,27 +184,29 @@ function(boost_modular_build)
     else()
         list(APPEND B2_OPTIONS threadapi=pthread)
     endif()
-    list(APPEND B2_OPTIONS_DBG
-         -sZLIB_BINARY=zlibd
-         "-sZLIB_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
-         -sBZIP2_BINARY=bz2d
-         "-sBZIP2_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
-         -sLZMA_BINARY=lzmad
-         "-sLZMA_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
-         -sZSTD_BINARY=zstdd
-         "-sZSTD_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
-    )
+    if(PORT STREQUAL "boost-iostreams")
+        list(APPEND B2_OPTIONS_DBG
+             -sZLIB_BINARY=zlibd
+             "-sZLIB_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
+             -sBZIP2_BINARY=bz2d
+             "-sBZIP2_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
+             -sLZMA_BINARY=lzmad
+             "-sLZMA_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
+             -sZSTD_BINARY=zstdd
+             "-sZSTD_LIBPATH=${CURRENT_INSTALLED_DIR}/debug/lib"
+        )
 
-    list(APPEND B2_OPTIONS_REL
-         -sZLIB_BINARY=zlib
-         "-sZLIB_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
-         -sBZIP2_BINARY=bz2
-         "-sBZIP2_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
-         -sLZMA_BINARY=lzma
-         "-sLZMA_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
-         -sZSTD_BINARY=zstd
-         "-sZSTD_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
-    )
+        list(APPEND B2_OPTIONS_REL
+             -sZLIB_BINARY=zlib
+             "-sZLIB_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
+             -sBZIP2_BINARY=bz2
+             "-sBZIP2_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
+             -sLZMA_BINARY=lzma
+             "-sLZMA_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
+             -sZSTD_BINARY=zstd
+             "-sZSTD_LIBPATH=${CURRENT_INSTALLED_DIR}/lib"
+        )
+    endif()
 
     # Properly handle compiler and linker flags passed by VCPKG
     if(VCPKG_CXX_FLAGS)
@@ -245,6 +245,31 @@ function(boost_modular_build)
         list(APPEND B2_OPTIONS_DBG "linkflags=${VCPKG_LINKER_FLAGS_DEBUG}")
     endif()
 
+    # The options of a single variant become conditional requirements in the Jamroot,
+    # except for variables, which are passed to the run of b2 for that variant.
+    list(APPEND B2_OPTIONS_REL debug-symbols=on)
+    set(B2_VARIABLES_REL)
+    set(B2_VARIABLES_DBG)
+    foreach(SUFFIX IN ITEMS REL DBG)
+        if(SUFFIX STREQUAL "REL")
+            set(VARIANT release)
+        else()
+            set(VARIANT debug)
+        endif()
+        foreach(OPTION IN LISTS B2_OPTIONS_${SUFFIX})
+            if(OPTION MATCHES "^-")
+                list(APPEND B2_VARIABLES_${SUFFIX} "${OPTION}")
+            elseif(OPTION MATCHES "^([^=]+)=(.*)$")
+                set(FEATURE "${CMAKE_MATCH_1}")
+                string(REPLACE "\\" "\\\\" VALUE "${CMAKE_MATCH_2}")
+                string(REPLACE "\"" "\\\"" VALUE "${VALUE}")
+                string(APPEND B2_REQUIREMENTS " <variant>${VARIANT}:<${FEATURE}>\"${VALUE}\"")
+            else()
+                message(FATAL_ERROR "Unsupported option for the ${VARIANT} variant: ${OPTION}")
+            endif()
+        endforeach()
+    endforeach()
+
     # Add build type specific options
     if(VCPKG_CRT_LINKAGE STREQUAL "dynamic")
         list(APPEND B2_OPTIONS runtime-link=shared)
@@ -316,66 +341,67 @@ function(boost_modular_build)
         message(FATAL_ERROR "Unsupported value for VCPKG_PLATFORM_TOOLSET: '${VCPKG_PLATFORM_TOOLSET}'")
     endif()
 
-    configure_file(${_bm_DIR}/user-config.jam ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/user-config.jam @ONLY)
-    configure_file(${_bm_DIR}/user-config.jam ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/user-config.jam @ONLY)
+    foreach(BUILD_DIR IN LISTS BUILD_DIRS)
+        configure_file(${_bm_DIR}/user-config.jam ${BUILD_DIR}/user-config.jam @ONLY)
+    endforeach()
+    configure_file(${_bm_DIR}/Jamroot.jam ${_bm_SOURCE_PATH}/Jamroot.jam @ONLY)
+    set(ENV{BOOST_BUILD_PATH} "${BOOST_BUILD_PATH}")
 
     ######################
     # Perform build + Package
     ######################
-    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "release")
-        message(STATUS "Building ${TARGET_TRIPLET}-rel")
-        set(BOOST_LIB_SUFFIX ${BOOST_LIB_RELEASE_SUFFIX})
-        set(VARIANT "release")
-        set(BUILD_LIB_PATH "lib/")
-        configure_file(${_bm_DIR}/Jamroot.jam ${_bm_SOURCE_PATH}/Jamroot.jam @ONLY)
-        set(ENV{BOOST_BUILD_PATH} "${BOOST_BUILD_PATH}")
-        vcpkg_execute_required_process(
-            COMMAND "${B2_EXE}"
-                --stagedir=${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/stage
-                --build-dir=${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel
-                --user-config=${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/user-config.jam
-                ${B2_OPTIONS}
-                ${B2_OPTIONS_REL}
-                variant=release
-                debug-symbols=on
-            WORKING_DIRECTORY ${_bm_SOURCE_PATH}/build
-            LOGNAME build-${TARGET_TRIPLET}-rel
-        )
-        message(STATUS "Building ${TARGET_TRIPLET}-rel done")
-    endif()
-
-    if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-        message(STATUS "Building ${TARGET_TRIPLET}-dbg")
-        set(BOOST_LIB_SUFFIX ${BOOST_LIB_DEBUG_SUFFIX})
-        set(VARIANT debug)
-        set(BUILD_LIB_PATH "debug/lib/")
-        configure_file(${_bm_DIR}/Jamroot.jam ${_bm_SOURCE_PATH}/Jamroot.jam @ONLY)
-        set(ENV{BOOST_BUILD_PATH} "${BOOST_BUILD_PATH}")
+    if(BUILD_VARIANTS_SEPARATELY)
+        foreach(VARIANT IN LISTS B2_VARIANTS)
+            if(VARIANT STREQUAL "release")
+                set(BUILD_DIR ${BUILD_DIR_REL})
+                set(SUFFIX rel)
+            else()
+                set(BUILD_DIR ${BUILD_DIR_DBG})
+                set(SUFFIX dbg)
+            endif()
+            string(TOUPPER "${SUFFIX}" SUFFIX_UPPER)
+            message(STATUS "Building ${TARGET_TRIPLET}-${SUFFIX}")
+            vcpkg_execute_required_process(
+                COMMAND "${B2_EXE}"
+                    --stagedir=${BUILD_DIR}/stage
+                    --build-dir=${BUILD_DIR}
+                    --user-config=${BUILD_DIR}/user-config.jam
+                    ${B2_OPTIONS}
+                    ${B2_VARIABLES_${SUFFIX_UPPER}}
+                    variant=${VARIANT}
+                WORKING_DIRECTORY ${_bm_SOURCE_PATH}/build
+                LOGNAME build-${TARGET_TRIPLET}-${SUFFIX}
+            )
+            message(STATUS "Building ${TARGET_TRIPLET}-${SUFFIX} done")
+        endforeach()
+    else()
+        list(JOIN B2_VARIANTS "," B2_VARIANT_LIST)
+        message(STATUS "Building ${TARGET_TRIPLET}")
         vcpkg_execute_required_process(
             COMMAND "${B2_EXE}"
-                --stagedir=${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/stage
-                --build-dir=${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg
-                --user-config=${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/user-config.jam
+                --stagedir=${BUILD_DIR_REL}/stage
+                --build-dir=${BUILD_DIR_REL}
+                --user-config=${BUILD_DIR_REL}/user-config.jam
                 ${B2_OPTIONS}
-                ${B2_OPTIONS_DBG}
-                variant=debug
+                variant=${B2_VARIANT_LIST}
             WORKING_DIRECTORY ${_bm_SOURCE_PATH}/build
-            LOGNAME build-${TARGET_TRIPLET}-dbg
+            LOGNAME build-${TARGET_TRIPLET}
         )
-        message(STATUS "Building ${TARGET_TRIPLET}-dbg done")
+        message(STATUS "Building ${TARGET_TRIPLET} done")
     endif()
 
+    # The Jamroot stages the libraries of each variant in a directory of its own.
     if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "release")
         message(STATUS "Packaging ${TARGET_TRIPLET}-rel")
         file(GLOB REL_LIBS
-            ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/boost/build/*/*.lib
-            ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/boost/build/*/*.a
-            ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/boost/build/*/*.so
+            ${BUILD_DIR_REL}/stage/lib/*.lib
+            ${BUILD_DIR_REL}/stage/lib/*.a
+            ${BUILD_DIR_REL}/stage/lib/*.so
         )
         file(COPY ${REL_LIBS}
             DESTINATION ${CURRENT_PACKAGES_DIR}/lib)
         if (VCPKG_LIBRARY_LINKAGE STREQUAL dynamic)
-            file(GLOB REL_DLLS ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel/boost/build/*/*.dll)
+            file(GLOB REL_DLLS ${BUILD_DIR_REL}/stage/lib/*.dll)
             file(COPY ${REL_DLLS}
                 DESTINATION ${CURRENT_PACKAGES_DIR}/bin
                 FILES_MATCHING PATTERN "*.dll")
@@ -386,14 +412,14 @@ function(boost_modular_build)
     if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
         message(STATUS "Packaging ${TARGET_TRIPLET}-dbg")
         file(GLOB DBG_LIBS
-            ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/boost/build/*/*.lib
-            ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/boost/build/*/*.a
-            ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/boost/build/*/*.so
+            ${BUILD_DIR_DBG}/stage/debug/lib/*.lib
+            ${BUILD_DIR_DBG}/stage/debug/lib/*.a
+            ${BUILD_DIR_DBG}/stage/debug/lib/*.so
         )
         file(COPY ${DBG_LIBS}
             DESTINATION ${CURRENT_PACKAGES_DIR}/debug/lib)
         if (VCPKG_LIBRARY_LINKAGE STREQUAL dynamic)
-            file(GLOB DBG_DLLS ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-dbg/boost/build/*/*.dll)
+            file(GLOB DBG_DLLS ${BUILD_DIR_DBG}/stage/debug/lib/*.dll)
             file(COPY ${DBG_DLLS}
                 DESTINATION ${CURRENT_PACKAGES_DIR}/debug/bin
                 FILES_MATCHING PATTERN "*.dll")
@@ -7,9 +7,9 @@ function(boost_modular_headers)
 
     message(STATUS "Packaging headers")
 
-    file(
-        COPY ${_bm_SOURCE_PATH}/include/boost
-        DESTINATION ${CURRENT_PACKAGES_DIR}/include
+    vcpkg_install_headers(
+        SOURCE ${_bm_SOURCE_PATH}/include/boost
+        DESTINATION ${CURRENT_PACKAGES_DIR}/include/boost
     )
 
     message(STATUS "Packaging headers done")
@@ -2,6 +2,10 @@ if(NOT VCPKG_TARGET_ARCHITECTURE STREQUAL x64)
   message(FATAL_ERROR "Folly only supports the x64 architecture.")
 endif()
 
+if("io-uring" IN_LIST FEATURES AND NOT VCPKG_TARGET_IS_LINUX)
+  message(FATAL_ERROR "Feature io-uring is only supported on Linux.")
+endif()
+
 vcpkg_check_linkage(ONLY_STATIC_LIBRARY)
 
 # Required to run build/generate_escape_tables.py et al.
@@ -51,6 +55,7 @@ feature(lzma LibLZMA)
 feature(lz4 LZ4)
 feature(zstd Zstd)
 feature(snappy Snappy)
+feature(io-uring LibUring)
 
 vcpkg_configure_cmake(
     SOURCE_PATH ${SOURCE_PATH}
@@ -0,0 +1,82 @@
+vcpkg_fail_port_install(ON_TARGET "Windows" "OSX" "UWP")
+
+vcpkg_from_github(
+    OUT_SOURCE_PATH SOURCE_PATH
+    REPO axboe/liburing
+    REF liburing-2.0
+    SHA512 0
+    HEAD_REF master
+)
+
+# Use the compilers, tools and flags of the toolchain, as vcpkg_configure_make does.
+vcpkg_internal_get_cmake_vars(OUTPUT_FILE cmake_vars_file)
+include("${cmake_vars_file}")
+
+# liburing has a handwritten configure script and Makefiles which only build in the source tree,
+# so each configuration is built in a copy of the sources.
+foreach(BUILDTYPE IN ITEMS dbg rel)
+    if(BUILDTYPE STREQUAL "dbg")
+        if(VCPKG_BUILD_TYPE STREQUAL "release")
+            continue()
+        endif()
+        set(CONFIG DEBUG)
+        set(PREFIX "${CURRENT_PACKAGES_DIR}/debug")
+    else()
+        set(CONFIG RELEASE)
+        set(PREFIX "${CURRENT_PACKAGES_DIR}")
+    endif()
+    set(CC "${VCPKG_DETECTED_CMAKE_C_COMPILER}")
+    # Set up by z_vcpkg_compiler_cache_begin when the triplet sets VCPKG_COMPILER_CACHE
+    if(DEFINED Z_VCPKG_COMPILER_CACHE_LAUNCHER_${CONFIG})
+        set(CC "${Z_VCPKG_COMPILER_CACHE_LAUNCHER_${CONFIG}} ${CC}")
+    endif()
+    set(MAKE_OPTIONS
+        "CC=${CC}"
+        "AR=${VCPKG_DETECTED_CMAKE_AR}"
+        "RANLIB=${VCPKG_DETECTED_CMAKE_RANLIB}"
+        "CFLAGS=${VCPKG_DETECTED_CMAKE_C_FLAGS_${CONFIG}}"
+        "LDFLAGS=${VCPKG_DETECTED_CMAKE_SHARED_LINKER_FLAGS_${CONFIG}}"
+    )
+    set(BUILD_DIR "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${BUILDTYPE}")
+    file(REMOVE_RECURSE "${BUILD_DIR}")
+    file(COPY "${SOURCE_PATH}/" DESTINATION "${BUILD_DIR}")
+
+    message(STATUS "Configuring ${TARGET_TRIPLET}-${BUILDTYPE}")
+    vcpkg_execute_required_process(
+        COMMAND ./configure
+            "--prefix=${PREFIX}"
+            "--includedir=${PREFIX}/include"
+            "--libdir=${PREFIX}/lib"
+            "--libdevdir=${PREFIX}/lib"
+            "--mandir=${PREFIX}/share/man"
+            "--cc=${VCPKG_DETECTED_CMAKE_C_COMPILER}"
+        WORKING_DIRECTORY "${BUILD_DIR}"
+        LOGNAME configure-${TARGET_TRIPLET}-${BUILDTYPE}
+    )
+    message(STATUS "Building ${TARGET_TRIPLET}-${BUILDTYPE}")
+    vcpkg_execute_required_process(
+        COMMAND make -C src -j${VCPKG_CONCURRENCY} ${MAKE_OPTIONS}
+        WORKING_DIRECTORY "${BUILD_DIR}"
+        LOGNAME build-${TARGET_TRIPLET}-${BUILDTYPE}
+    )
+    vcpkg_execute_required_process(
+        COMMAND make install ${MAKE_OPTIONS}
+        WORKING_DIRECTORY "${BUILD_DIR}"
+        LOGNAME install-${TARGET_TRIPLET}-${BUILDTYPE}
+    )
+endforeach()
+
+# The Makefiles always build and install both the static and the shared library.
+if(VCPKG_LIBRARY_LINKAGE STREQUAL "static")
+    file(GLOB SHARED_LIBS "${CURRENT_PACKAGES_DIR}/lib/liburing.so*" "${CURRENT_PACKAGES_DIR}/debug/lib/liburing.so*")
+    file(REMOVE ${SHARED_LIBS})
+else()
+    file(REMOVE "${CURRENT_PACKAGES_DIR}/lib/liburing.a" "${CURRENT_PACKAGES_DIR}/debug/lib/liburing.a")
+endif()
+
+vcpkg_fixup_pkgconfig()
+
+file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/debug/include" "${CURRENT_PACKAGES_DIR}/debug/share" "${CURRENT_PACKAGES_DIR}/share/man")
+
+file(INSTALL "${CMAKE_CURRENT_LIST_DIR}/usage" DESTINATION "${CURRENT_PACKAGES_DIR}/share/${PORT}")
+file(INSTALL "${SOURCE_PATH}/LICENSE" DESTINATION "${CURRENT_PACKAGES_DIR}/share/${PORT}" RENAME copyright)
@@ -195,6 +195,10 @@ vcpkg_find_acquire_program(PYTHON3)
 get_filename_component(PYTHON3_DIR ${PYTHON3} DIRECTORY)
 vcpkg_add_to_path(${PYTHON3_DIR})
 
+# Linking the LLVM tools needs much more memory than the default estimate,
+# so fewer link jobs run at the same time.
+set(VCPKG_LINK_JOB_MEMORY 8192)
+
 vcpkg_configure_cmake(
     SOURCE_PATH ${SOURCE_PATH}/llvm
     PREFER_NINJA
@@ -212,8 +216,6 @@ vcpkg_configure_cmake(
         "-DLLVM_ENABLE_PROJECTS=${LLVM_ENABLE_PROJECTS}"
         "-DLLVM_TARGETS_TO_BUILD=${LLVM_TARGETS_TO_BUILD}"
         -DPACKAGE_VERSION=${LLVM_VERSION}
-        # Limit the maximum number of concurrent link jobs to 1. This should fix low amount of memory issue for link.
-        -DLLVM_PARALLEL_LINK_JOBS=1
         # Disable build LLVM-C.dll (Windows only) due to doesn't compile with CMAKE_DEBUG_POSTFIX
         -DLLVM_BUILD_LLVM_C_DYLIB=OFF
         # Path for binary subdirectory (defaults to 'bin')
@@ -25,8 +25,41 @@ set(PATH_BACKUP "$ENV{PATH}")
 vcpkg_add_to_path("${PERL_EXE_PATH}")
 vcpkg_add_to_path("${SED_EXE_PATH}")
 
+if("serial" IN_LIST FEATURES AND "openmp" IN_LIST FEATURES)
+    message(FATAL_ERROR "Features serial and openmp are mutually exclusive.")
+endif()
+
 set(COMMON_OPTIONS -DBUILD_WITHOUT_LAPACK=ON)
 
+# threads is a default feature; the other threading models override it.
+if("openmp" IN_LIST FEATURES)
+    list(APPEND COMMON_OPTIONS -DUSE_THREAD=1 -DUSE_OPENMP=1)
+elseif("threads" IN_LIST FEATURES AND NOT "serial" IN_LIST FEATURES)
+    list(APPEND COMMON_OPTIONS -DUSE_THREAD=1 -DUSE_OPENMP=0)
+else()
+    list(APPEND COMMON_OPTIONS -DUSE_THREAD=0 -DUSE_OPENMP=0)
+endif()
+
+# The maximum number of threads is fixed at build time. OpenBLAS defaults to the number of cores
+# of the machine which builds it, so set it explicitly; a triplet can change it with
+# set(VCPKG_OPENBLAS_NUM_THREADS <n>) for the openblas port.
+if(NOT DEFINED VCPKG_OPENBLAS_NUM_THREADS)
+    set(VCPKG_OPENBLAS_NUM_THREADS 64)
+endif()
+if(NOT VCPKG_OPENBLAS_NUM_THREADS MATCHES "^[1-9][0-9]*$")
+    message(FATAL_ERROR "VCPKG_OPENBLAS_NUM_THREADS must be a positive number; got '${VCPKG_OPENBLAS_NUM_THREADS}'.")
+endif()
+list(APPEND COMMON_OPTIONS -DNUM_THREADS=${VCPKG_OPENBLAS_NUM_THREADS})
+
+if("dynamic-arch" IN_LIST FEATURES)
+    if(NOT VCPKG_TARGET_ARCHITECTURE MATCHES "^(x86|x64)$")
+        message(FATAL_ERROR "Feature dynamic-arch is only supported on x86 and x64.")
+    endif()
+    list(APPEND COMMON_OPTIONS -DDYNAMIC_ARCH=ON)
+else()
+    list(APPEND COMMON_OPTIONS -DDYNAMIC_ARCH=OFF)
+endif()
+
 # for UWP version, must build non uwp first for helper
 # binaries.
 if(VCPKG_TARGET_IS_UWP)
@@ -77,7 +110,6 @@ else()
         SOURCE_PATH ${SOURCE_PATH}
         OPTIONS
             ${COMMON_OPTIONS}
-            -DCMAKE_SYSTEM_PROCESSOR=AMD64
             -DNOFORTRAN=ON
             -DBU=_  #required for all blas functions to append extra _ using NAME
             )
@@ -88,6 +120,18 @@ vcpkg_install_cmake()
 vcpkg_fixup_cmake_targets(CONFIG_PATH share/cmake/OpenBLAS TARGET_PATH share/openblas)
 set(ENV{PATH} "${PATH_BACKUP}")
 
+if("openmp" IN_LIST FEATURES AND VCPKG_LIBRARY_LINKAGE STREQUAL "static")
+    set(OPENBLAS_LINK_OPENMP 1)
+    # The static library needs the OpenMP runtime; the CMake build of OpenBLAS does not export this dependency.
+    vcpkg_add_find_dependency(
+        CONFIG_FILE "${CURRENT_PACKAGES_DIR}/share/openblas/OpenBLASConfig.cmake"
+        FIND_DEPENDENCY OpenMP
+        TARGETS OpenBLAS::OpenBLAS OpenBLAS::openblas
+        LINK_LIBRARIES OpenMP::OpenMP_C
+    )
+    file(APPEND "${CURRENT_PACKAGES_DIR}/share/openblas/OpenBLASConfig.cmake" "list(APPEND OpenBLAS_LIBRARIES OpenMP::OpenMP_C)\n")
+endif()
+
 set(pcfile "${CURRENT_PACKAGES_DIR}/lib/pkgconfig/openblas.pc")
 if(EXISTS "${pcfile}")
     file(READ "${pcfile}" _contents)
@@ -102,6 +146,10 @@ if(EXISTS "${pcfile}")
     file(WRITE "${pcfile}" "${_contents}")
     #file(CREATE_LINK "${pcfile}" "${CURRENT_PACKAGES_DIR}/debug/lib/pkgconfig/blas.pc" COPY_ON_ERROR)
 endif()
+if(OPENBLAS_LINK_OPENMP AND NOT (VCPKG_TARGET_IS_WINDOWS AND NOT VCPKG_TARGET_IS_MINGW))
+    # MSVC objects built with /openmp pull in the OpenMP runtime by themselves; other toolchains need the flag.
+    vcpkg_add_pkgconfig_libs_private(NAME openblas LIBS -fopenmp)
+endif()
 vcpkg_fixup_pkgconfig()
 #maybe we need also to write a wrapper inside share/blas to search implicitly for openblas, whenever we feel it's ready for its own -config.cmake file
 
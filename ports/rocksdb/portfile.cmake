@@ -16,18 +16,40 @@ vcpkg_from_github(
 string(COMPARE EQUAL "${VCPKG_CRT_LINKAGE}" "dynamic" WITH_MD_LIBRARY)
 string(COMPARE EQUAL "${VCPKG_LIBRARY_LINKAGE}" "dynamic" ROCKSDB_BUILD_SHARED)
 
+foreach(LINUX_FEATURE IN ITEMS numa io-uring)
+  if(LINUX_FEATURE IN_LIST FEATURES AND NOT VCPKG_TARGET_IS_LINUX)
+    message(FATAL_ERROR "Feature ${LINUX_FEATURE} is only supported on Linux.")
+  endif()
+endforeach()
+
 vcpkg_check_features(OUT_FEATURE_OPTIONS FEATURE_OPTIONS
   FEATURES
-    "lz4"     WITH_LZ4
-    "snappy"  WITH_SNAPPY
-    "zlib"    WITH_ZLIB
-    "zstd"    WITH_ZSTD
-    "bzip2"   WITH_BZ2
-    "tbb"     WITH_TBB
+    "lz4"      WITH_LZ4
+    "snappy"   WITH_SNAPPY
+    "zlib"     WITH_ZLIB
+    "zstd"     WITH_ZSTD
+    "bzip2"    WITH_BZ2
+    "tbb"      WITH_TBB
+    "numa"     WITH_NUMA
+    "jemalloc" WITH_JEMALLOC
+    "io-uring" WITH_LIBURING
   INVERTED_FEATURES
-    "tbb"     CMAKE_DISABLE_FIND_PACKAGE_TBB
+    "tbb"      CMAKE_DISABLE_FIND_PACKAGE_TBB
+    "numa"     CMAKE_DISABLE_FIND_PACKAGE_NUMA
 )
 
+# PORTABLE=OFF would build with -march=native, for a CPU which is not part of the ABI hash of the package.
+# native instead builds for VCPKG_TARGET_ISA_LEVEL, which the toolchain passes as -march=x86-64-<level>.
+if("native" IN_LIST FEATURES)
+  if(NOT VCPKG_TARGET_ISA_LEVEL)
+    message(FATAL_ERROR "Feature native requires a triplet which sets VCPKG_TARGET_ISA_LEVEL, such as x64-linux-v3.")
+  endif()
+  if(VCPKG_TARGET_ISA_LEVEL MATCHES "^v[34]$")
+    # All CPUs with AVX2 also have SSE4.2 and PCLMULQDQ, which rocksdb then uses without checking at runtime.
+    list(APPEND FEATURE_OPTIONS -DFORCE_SSE42=ON)
+  endif()
+endif()
+
 vcpkg_configure_cmake(
   SOURCE_PATH ${SOURCE_PATH}
   PREFER_NINJA
@@ -44,7 +66,6 @@ vcpkg_configure_cmake(
     -DPORTABLE=ON
     -DCMAKE_DEBUG_POSTFIX=d
     -DROCKSDB_BUILD_SHARED=${ROCKSDB_BUILD_SHARED}
-    -DCMAKE_DISABLE_FIND_PACKAGE_NUMA=TRUE
     -DCMAKE_DISABLE_FIND_PACKAGE_gtest=TRUE
     -DCMAKE_DISABLE_FIND_PACKAGE_Git=TRUE
     ${FEATURE_OPTIONS}
@@ -54,6 +75,17 @@ vcpkg_install_cmake()
 
 vcpkg_fixup_cmake_targets(CONFIG_PATH lib/cmake/rocksdb)
 
+# RocksDBConfig.cmake finds NUMA, JeMalloc and liburing with the modules of rocksdb.
+if("numa" IN_LIST FEATURES)
+  file(INSTALL ${SOURCE_PATH}/cmake/modules/FindNUMA.cmake DESTINATION ${CURRENT_PACKAGES_DIR}/share/${PORT}/modules)
+endif()
+if("jemalloc" IN_LIST FEATURES)
+  file(INSTALL ${SOURCE_PATH}/cmake/modules/FindJeMalloc.cmake DESTINATION ${CURRENT_PACKAGES_DIR}/share/${PORT}/modules)
+endif()
+if("io-uring" IN_LIST FEATURES)
+  file(INSTALL ${SOURCE_PATH}/cmake/modules/Finduring.cmake DESTINATION ${CURRENT_PACKAGES_DIR}/share/${PORT}/modules)
+endif()
+
 file(REMOVE_RECURSE ${CURRENT_PACKAGES_DIR}/debug/include)
 
 file(INSTALL ${SOURCE_PATH}/LICENSE.Apache DESTINATION ${CURRENT_PACKAGES_DIR}/share/${PORT} RENAME copyright)
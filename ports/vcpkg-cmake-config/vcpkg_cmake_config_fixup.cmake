@@ -60,6 +60,7 @@ function(vcpkg_cmake_config_fixup)
     if(NOT arg_PACKAGE_NAME)
         set(arg_PACKAGE_NAME "${PORT}")
     endif()
+    z_vcpkg_trace_begin("cmake_config_fixup ${arg_PACKAGE_NAME}" CATEGORY fixup)
     if(NOT arg_CONFIG_PATH)
         set(arg_CONFIG_PATH "share/${arg_PACKAGE_NAME}")
     endif()
@@ -232,6 +233,7 @@ get_filename_component(_IMPORT_PREFIX "${_IMPORT_PREFIX}" PATH)]]
     if(remaining_files STREQUAL "")
         file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/debug/share")
     endif()
+    z_vcpkg_trace_end("cmake_config_fixup ${arg_PACKAGE_NAME}" CATEGORY fixup)
 endfunction()
 
 
@@ -1,3 +1,4 @@
 include("${CMAKE_CURRENT_LIST_DIR}/vcpkg_cmake_configure.cmake")
 include("${CMAKE_CURRENT_LIST_DIR}/vcpkg_cmake_build.cmake")
 include("${CMAKE_CURRENT_LIST_DIR}/vcpkg_cmake_install.cmake")
+include("${CMAKE_CURRENT_LIST_DIR}/vcpkg_cmake_pgo.cmake")
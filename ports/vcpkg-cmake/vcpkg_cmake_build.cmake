@@ -27,6 +27,14 @@ this is set to `install`, so you'll get log names like `install-x86-windows-dbg.
 For build systems that are buggy when run in parallel,
 using `DISABLE_PARALLEL` will run the build with only one job.
 
+If the triplet sets `VCPKG_CONCURRENT_BUILD_TYPES`,
+the debug and release builds run at the same time,
+each using half of the jobs.
+
+The number of jobs is `VCPKG_CONCURRENCY`, lowered if the available memory
+is not enough for that many jobs; see `VCPKG_COMPILE_JOB_MEMORY` in the triplet documentation.
+If the build fails because it ran out of memory, it is restarted with fewer jobs.
+
 Finally, `ADD_BIN_TO_PATH` adds the appropriate (either release or debug)
 `bin/` directories to the path during the build,
 such that executables run during the build will be able to access those DLLs.
@@ -51,16 +59,18 @@ function(vcpkg_cmake_build)
     set(parallel_args)
     set(no_parallel_args)
 
+    z_vcpkg_concurrent_build_begin(jobs)
+
     if(Z_VCPKG_CMAKE_GENERATOR STREQUAL "Ninja")
         set(build_args "-v") # verbose output
-        set(parallel_args "-j${VCPKG_CONCURRENCY}")
+        set(parallel_args "-j${jobs}")
         set(no_parallel_args "-j1")
     elseif(Z_VCPKG_CMAKE_GENERATOR MATCHES "^Visual Studio")
         set(build_args
             "/p:VCPkgLocalAppDataDisabled=true"
             "/p:UseIntelMKL=No"
         )
-        set(parallel_args "/m")
+        set(parallel_args "/m:${jobs}")
     elseif(Z_VCPKG_CMAKE_GENERATOR STREQUAL "NMake Makefiles")
         # No options are currently added for nmake builds
     else()
@@ -99,9 +109,11 @@ function(vcpkg_cmake_build)
                     LOGNAME "${arg_LOGFILE_BASE}-${TARGET_TRIPLET}-${short_buildtype}"
                 )
             else()
-                vcpkg_execute_build_process(
+                z_vcpkg_concurrent_build_add(
+                    BUILD_TYPE "${buildtype}"
                     COMMAND "${CMAKE_COMMAND}" --build . --config "${cmake_config}" ${target_args} -- ${build_args} ${parallel_args}
                     NO_PARALLEL_COMMAND "${CMAKE_COMMAND}" --build . --config "${cmake_config}" ${target_args} -- ${build_args} ${no_parallel_args}
+                    JOBS "${jobs}"
                     WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${short_buildtype}"
                     LOGNAME "${arg_LOGFILE_BASE}-${TARGET_TRIPLET}-${short_buildtype}"
                 )
@@ -112,4 +124,6 @@ function(vcpkg_cmake_build)
             endif()
         endif()
     endforeach()
+
+    z_vcpkg_concurrent_build_end()
 endfunction()
@@ -46,11 +46,17 @@ If used for this purpose, it should be set to `"NMake Makefiles"`.
 `vcpkg_cmake_buildsystem_build` and `install` do not support this being set to anything
 except for NMake.
 
+By default, the debug and release builds are configured in parallel,
+on every host where Ninja is available.
 For libraries which cannot be configured in parallel,
 pass the `DISABLE_PARALLEL_CONFIGURE` flag. This is needed, for example,
 if the library's build system writes back into the source directory during configure.
 This also disables the `CMAKE_DISABLE_SOURCE_CHANGES` option.
 
+When Ninja is the generator, link steps run in a job pool
+sized to the available memory divided by `VCPKG_LINK_JOB_MEMORY`.
+Ports which set up their own job pools should pass `CMAKE_JOB_POOLS` or `CMAKE_JOB_POOL_LINK` in `OPTIONS`.
+
 By default, this function adds flags to `CMAKE_C_FLAGS` and `CMAKE_CXX_FLAGS`
 which set the default character set to utf-8 for MSVC.
 If the library sets its own code page, pass the `NO_CHARSET_FLAG` option.
@@ -84,12 +90,39 @@ macro(z_vcpkg_cmake_configure_both_set_or_unset var1 var2)
     endif()
 endmacro()
 
+# Ninja runs the command through CreateProcess on Windows, and through `/bin/sh -c` elsewhere,
+# so each argument is quoted for the host before being escaped for ninja itself.
+function(z_vcpkg_cmake_configure_ninja_build_line out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "" "OUTPUT" "COMMAND")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_cmake_configure_ninja_build_line was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+
+    set(process "")
+    foreach(arg IN LISTS arg_COMMAND)
+        if(CMAKE_HOST_WIN32)
+            set(arg "\"${arg}\"")
+        else()
+            string(REPLACE "'" "'\\''" arg "${arg}")
+            set(arg "'${arg}'")
+        endif()
+        string(REPLACE "$" "$$" arg "${arg}")
+        string(APPEND process " ${arg}")
+    endforeach()
+    string(REPLACE "$" "$$" output "${arg_OUTPUT}")
+    string(REPLACE ":" "$:" output "${output}")
+    string(REPLACE " " "$ " output "${output}")
+
+    set("${out_var}" "build ${output}: CreateProcess\n  process =${process}" PARENT_SCOPE)
+endfunction()
+
 function(vcpkg_cmake_configure)
     cmake_parse_arguments(PARSE_ARGV 0 "arg"
         "PREFER_NINJA;DISABLE_PARALLEL_CONFIGURE;WINDOWS_USE_MSBUILD;NO_CHARSET_FLAG"
         "SOURCE_PATH;GENERATOR;LOGFILE_BASE"
         "OPTIONS;OPTIONS_DEBUG;OPTIONS_RELEASE"
     )
+    z_vcpkg_trace_begin("cmake_configure" CATEGORY configure)
 
     if(DEFINED CACHE{Z_VCPKG_CMAKE_GENERATOR})
         message(WARNING "vcpkg_cmake_configure already called; this function should only be called once.")
@@ -286,6 +319,37 @@ function(vcpkg_cmake_configure)
         list(APPEND arg_OPTIONS "-A${arch}")
     endif()
 
+    # Set up by z_vcpkg_compiler_cache_begin when the triplet sets VCPKG_COMPILER_CACHE
+    foreach(buildtype IN ITEMS DEBUG RELEASE)
+        if(DEFINED Z_VCPKG_COMPILER_CACHE_LAUNCHER_${buildtype})
+            list(APPEND arg_OPTIONS_${buildtype} "-DVCPKG_COMPILER_CACHE_LAUNCHER=${Z_VCPKG_COMPILER_CACHE_LAUNCHER_${buildtype}}")
+        endif()
+    endforeach()
+
+    # Used by scripts/toolchains/linux.cmake
+    if(VCPKG_LTO)
+        list(APPEND arg_OPTIONS "-DVCPKG_LTO=${VCPKG_LTO}")
+    endif()
+    if(VCPKG_TARGET_ISA_LEVEL)
+        list(APPEND arg_OPTIONS "-DVCPKG_TARGET_ISA_LEVEL=${VCPKG_TARGET_ISA_LEVEL}")
+    endif()
+    if(VCPKG_LINKER)
+        list(APPEND arg_OPTIONS "-DVCPKG_LINKER=${VCPKG_LINKER}")
+    endif()
+
+    # Limit the number of concurrent link steps, which use much more memory than compiling
+    if(generator STREQUAL "Ninja" AND NOT arg_OPTIONS MATCHES "-DCMAKE_JOB_POOL")
+        if(VCPKG_CONCURRENT_BUILD_TYPES AND NOT DEFINED VCPKG_BUILD_TYPE)
+            z_vcpkg_get_build_jobs(link_jobs LINK CONCURRENT_BUILDS 2)
+        else()
+            z_vcpkg_get_build_jobs(link_jobs LINK)
+        endif()
+        list(APPEND arg_OPTIONS
+            "-DCMAKE_JOB_POOLS=vcpkg_link=${link_jobs}"
+            "-DCMAKE_JOB_POOL_LINK=vcpkg_link"
+        )
+    endif()
+
     # Sets configuration variables for macOS builds
     foreach(config_var IN ITEMS INSTALL_NAME_DIR OSX_DEPLOYMENT_TARGET OSX_SYSROOT OSX_ARCHITECTURES)
         if(DEFINED VCPKG_${config_var})
@@ -293,7 +357,7 @@ function(vcpkg_cmake_configure)
         endif()
     endforeach()
 
-    if(ninja_host AND CMAKE_HOST_WIN32 AND NOT arg_DISABLE_PARALLEL_CONFIGURE)
+    if(ninja_host AND NOT arg_DISABLE_PARALLEL_CONFIGURE)
         list(APPEND arg_OPTIONS "-DCMAKE_DISABLE_SOURCE_CHANGES=ON")
 
         vcpkg_find_acquire_program(NINJA)
@@ -310,37 +374,29 @@ function(vcpkg_cmake_configure)
         )
 
         if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "release")
-            set(line "build ../CMakeCache.txt: CreateProcess\n  ")
-            string(APPEND line "process = \"${CMAKE_COMMAND}\" -S \"${arg_SOURCE_PATH}\" -B .. ")
-
-            if(DEFINED arg_OPTIONS AND NOT arg_OPTIONS STREQUAL "")
-                list(JOIN arg_OPTIONS "\" \"" options)
-                string(APPEND line "\"${options}\" ")
-            endif()
-            if(DEFINED arg_OPTIONS_RELEASE AND NOT arg_OPTIONS_RELEASE STREQUAL "")
-                list(JOIN arg_OPTIONS_RELEASE "\" \"" options_rel)
-                string(APPEND line "\"${options_rel}\" ")
-            endif()
-            string(APPEND line "-G \"${generator}\" ")
-            string(APPEND line "\"-DCMAKE_BUILD_TYPE=Release\" ")
-            string(APPEND line "\"-DCMAKE_INSTALL_PREFIX=${CURRENT_PACKAGES_DIR}\"")
+            z_vcpkg_cmake_configure_ninja_build_line(line
+                OUTPUT "../CMakeCache.txt"
+                COMMAND
+                    "${CMAKE_COMMAND}" -S "${arg_SOURCE_PATH}" -B ..
+                    ${arg_OPTIONS}
+                    ${arg_OPTIONS_RELEASE}
+                    -G "${generator}"
+                    "-DCMAKE_BUILD_TYPE=Release"
+                    "-DCMAKE_INSTALL_PREFIX=${CURRENT_PACKAGES_DIR}"
+            )
             string(APPEND parallel_configure_contents "${line}\n\n")
         endif()
         if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-            set(line "build ../../${TARGET_TRIPLET}-dbg/CMakeCache.txt: CreateProcess\n  ")
-            string(APPEND line "process = \"${CMAKE_COMMAND}\" -S \"${arg_SOURCE_PATH}\" -B \"../../${TARGET_TRIPLET}-dbg\" ")
-
-            if(DEFINED arg_OPTIONS AND NOT arg_OPTIONS STREQUAL "")
-                list(JOIN arg_OPTIONS "\" \"" options)
-                string(APPEND line "\"${options}\" ")
-            endif()
-            if(DEFINED arg_OPTIONS_DEBUG AND NOT arg_OPTIONS_DEBUG STREQUAL "")
-                list(JOIN arg_OPTIONS_DEBUG "\" \"" options_dbg)
-                string(APPEND line "\"${options_dbg}\" ")
-            endif()
-            string(APPEND line "-G \"${generator}\" ")
-            string(APPEND line "\"-DCMAKE_BUILD_TYPE=Debug\" ")
-            string(APPEND line "\"-DCMAKE_INSTALL_PREFIX=${CURRENT_PACKAGES_DIR}/debug\"")
+            z_vcpkg_cmake_configure_ninja_build_line(line
+                OUTPUT "../../${TARGET_TRIPLET}-dbg/CMakeCache.txt"
+                COMMAND
+                    "${CMAKE_COMMAND}" -S "${arg_SOURCE_PATH}" -B "../../${TARGET_TRIPLET}-dbg"
+                    ${arg_OPTIONS}
+                    ${arg_OPTIONS_DEBUG}
+                    -G "${generator}"
+                    "-DCMAKE_BUILD_TYPE=Debug"
+                    "-DCMAKE_INSTALL_PREFIX=${CURRENT_PACKAGES_DIR}/debug"
+            )
             string(APPEND parallel_configure_contents "${line}\n\n")
         endif()
 
@@ -388,4 +444,5 @@ function(vcpkg_cmake_configure)
     endif()
 
     set(Z_VCPKG_CMAKE_GENERATOR "${generator}" CACHE INTERNAL "The generator which was used to configure CMake.")
+    z_vcpkg_trace_end("cmake_configure" CATEGORY configure)
 endfunction()
@@ -0,0 +1,258 @@
+#[===[.md:
+# vcpkg_cmake_pgo
+
+Configure a CMake buildsystem, optimizing the release build with a profile of a training workload.
+
+```cmake
+vcpkg_cmake_pgo(
+    SOURCE_PATH <source-path>
+    [TRAINING_SCRIPT <script>]
+    [OPTIONS_TRAINING
+        <configure-setting>...]
+    <vcpkg_cmake_configure arguments>...
+)
+```
+
+`vcpkg_cmake_pgo` takes the place of [`vcpkg_cmake_configure()`] in a portfile,
+and accepts all of its arguments.
+If the triplet does not enable profile-guided optimization, it only calls `vcpkg_cmake_configure()`.
+
+If the triplet sets `VCPKG_PGO`, `vcpkg_cmake_pgo` first configures and builds
+an instrumented release build of the port, with the options of the release build and `OPTIONS_TRAINING`,
+and runs the training script, which should exercise the hot paths of the library.
+The profile written by the instrumented build is then stored,
+and the port is configured as usual, with the profile applied to the release build.
+The debug build is not affected.
+
+The training script is a CMake script which is `include()`d with the following variables set:
+* `PGO_BUILD_DIR`: the directory of the instrumented build,
+* `SOURCE_PATH`: the `SOURCE_PATH` passed to `vcpkg_cmake_pgo`.
+
+It typically runs a benchmark or test program of the project with `vcpkg_execute_required_process()`,
+building it first with `vcpkg_cmake_build(TARGET ...)` if the default target does not.
+A script named `<port>.cmake` in the directory named by `VCPKG_PGO_TRAINING_DIR` takes precedence over `TRAINING_SCRIPT`,
+so that users can train a port on their own workload.
+If there is no training script, the port is built without profile-guided optimization.
+
+Profiles are stored below `VCPKG_PGO_PROFILE_DIR`, which is `${DOWNLOADS}/pgo-profiles` by default,
+keyed by the port files, the training script, the compiler, the flags and the options of the build.
+Later builds of the port with the same key use the stored profile instead of running the training again.
+
+Profile-guided optimization is supported with GCC and clang, on hosts which can run the binaries they build.
+With GCC, the profile also depends on the directory the port is built in.
+
+## Examples
+
+* [zstd](https://github.com/Microsoft/vcpkg/blob/master/ports/zstd/portfile.cmake)
+#]===]
+if(Z_VCPKG_CMAKE_PGO_GUARD)
+    return()
+endif()
+set(Z_VCPKG_CMAKE_PGO_GUARD ON CACHE INTERNAL "guard variable")
+
+function(z_vcpkg_cmake_pgo_find_profdata out_var compiler)
+    get_filename_component(compiler_dir "${compiler}" DIRECTORY)
+    string(REGEX MATCH "^[0-9]+" major "${VCPKG_DETECTED_CMAKE_CXX_COMPILER_VERSION}")
+    find_program(Z_VCPKG_CMAKE_PGO_PROFDATA
+        NAMES "llvm-profdata-${major}" llvm-profdata
+        HINTS "${compiler_dir}"
+    )
+    if(NOT Z_VCPKG_CMAKE_PGO_PROFDATA AND CMAKE_HOST_APPLE)
+        execute_process(
+            COMMAND xcrun --find llvm-profdata
+            OUTPUT_VARIABLE profdata
+            OUTPUT_STRIP_TRAILING_WHITESPACE
+            RESULT_VARIABLE error_code
+        )
+        if(NOT error_code)
+            set(Z_VCPKG_CMAKE_PGO_PROFDATA "${profdata}" CACHE FILEPATH "" FORCE)
+        endif()
+    endif()
+    set("${out_var}" "${Z_VCPKG_CMAKE_PGO_PROFDATA}" PARENT_SCOPE)
+endfunction()
+
+function(vcpkg_cmake_pgo)
+    cmake_parse_arguments(PARSE_ARGV 0 "arg"
+        "PREFER_NINJA;DISABLE_PARALLEL_CONFIGURE;WINDOWS_USE_MSBUILD;NO_CHARSET_FLAG"
+        "SOURCE_PATH;GENERATOR;LOGFILE_BASE;TRAINING_SCRIPT"
+        "OPTIONS;OPTIONS_DEBUG;OPTIONS_RELEASE;OPTIONS_TRAINING"
+    )
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "vcpkg_cmake_pgo was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT DEFINED arg_SOURCE_PATH)
+        message(FATAL_ERROR "SOURCE_PATH must be set")
+    endif()
+
+    set(configure_args SOURCE_PATH "${arg_SOURCE_PATH}")
+    foreach(option IN ITEMS PREFER_NINJA DISABLE_PARALLEL_CONFIGURE WINDOWS_USE_MSBUILD NO_CHARSET_FLAG)
+        if(arg_${option})
+            list(APPEND configure_args "${option}")
+        endif()
+    endforeach()
+    foreach(keyword IN ITEMS GENERATOR LOGFILE_BASE)
+        if(DEFINED arg_${keyword})
+            list(APPEND configure_args "${keyword}" "${arg_${keyword}}")
+        endif()
+    endforeach()
+    set(configure_options
+        OPTIONS ${arg_OPTIONS}
+        OPTIONS_DEBUG ${arg_OPTIONS_DEBUG}
+        OPTIONS_RELEASE ${arg_OPTIONS_RELEASE}
+    )
+
+    if(NOT DEFINED VCPKG_PGO_PROFILE_DIR)
+        set(VCPKG_PGO_PROFILE_DIR "${DOWNLOADS}/pgo-profiles")
+    endif()
+
+    if(NOT VCPKG_PGO OR VCPKG_BUILD_TYPE STREQUAL "debug")
+        vcpkg_cmake_configure(${configure_args} ${configure_options})
+        return()
+    endif()
+
+    set(training_script "")
+    if(DEFINED VCPKG_PGO_TRAINING_DIR AND EXISTS "${VCPKG_PGO_TRAINING_DIR}/${PORT}.cmake")
+        set(training_script "${VCPKG_PGO_TRAINING_DIR}/${PORT}.cmake")
+    elseif(DEFINED arg_TRAINING_SCRIPT)
+        if(NOT EXISTS "${arg_TRAINING_SCRIPT}")
+            message(FATAL_ERROR "TRAINING_SCRIPT does not exist: ${arg_TRAINING_SCRIPT}")
+        endif()
+        set(training_script "${arg_TRAINING_SCRIPT}")
+    endif()
+    if(training_script STREQUAL "")
+        message(STATUS "No PGO training script for ${PORT}; building without profile-guided optimization")
+        vcpkg_cmake_configure(${configure_args} ${configure_options})
+        return()
+    endif()
+
+    vcpkg_internal_get_cmake_vars(OUTPUT_FILE cmake_vars_file)
+    include("${cmake_vars_file}")
+    set(compiler_id "${VCPKG_DETECTED_CMAKE_CXX_COMPILER_ID}")
+    set(reason "")
+    if(VCPKG_DETECTED_CMAKE_CROSSCOMPILING
+        OR NOT VCPKG_DETECTED_CMAKE_SYSTEM_NAME STREQUAL VCPKG_DETECTED_CMAKE_HOST_SYSTEM_NAME
+        OR NOT VCPKG_DETECTED_CMAKE_SYSTEM_PROCESSOR STREQUAL VCPKG_DETECTED_CMAKE_HOST_SYSTEM_PROCESSOR)
+        set(reason "the training workload cannot run on the host")
+    elseif(NOT compiler_id MATCHES "^(GNU|Clang|AppleClang)$" OR NOT VCPKG_DETECTED_CMAKE_C_COMPILER_ID STREQUAL compiler_id)
+        set(reason "it is not supported with the ${compiler_id} compiler")
+    endif()
+    if(NOT reason STREQUAL "")
+        message(WARNING "Building ${PORT} without profile-guided optimization: ${reason}.")
+        vcpkg_cmake_configure(${configure_args} ${configure_options})
+        return()
+    endif()
+
+    # GCC records the path of each object in the name of its profile.
+    set(key_inputs
+        "${compiler_id} ${VCPKG_DETECTED_CMAKE_CXX_COMPILER_VERSION} ${VCPKG_DETECTED_CMAKE_CXX_COMPILER}"
+        "${VCPKG_C_FLAGS} ${VCPKG_C_FLAGS_RELEASE} ${VCPKG_CXX_FLAGS} ${VCPKG_CXX_FLAGS_RELEASE}"
+        "${VCPKG_LINKER_FLAGS} ${VCPKG_LINKER_FLAGS_RELEASE} ${VCPKG_LIBRARY_LINKAGE} ${VCPKG_LTO} ${VCPKG_TARGET_ISA_LEVEL}"
+        "${FEATURES}"
+        "${arg_OPTIONS} ${arg_OPTIONS_RELEASE} ${arg_OPTIONS_TRAINING}"
+        "${CURRENT_BUILDTREES_DIR}"
+    )
+    file(GLOB_RECURSE port_files LIST_DIRECTORIES false "${CURRENT_PORT_DIR}/*")
+    list(SORT port_files)
+    foreach(file IN LISTS port_files training_script)
+        file(SHA512 "${file}" file_hash)
+        list(APPEND key_inputs "${file_hash}")
+    endforeach()
+    string(SHA512 key "${key_inputs}")
+    string(SUBSTRING "${key}" 0 16 key)
+    set(profile_dir "${VCPKG_PGO_PROFILE_DIR}/${PORT}-${TARGET_TRIPLET}-${key}")
+
+    if(compiler_id STREQUAL "GNU")
+        set(use_flags "-fprofile-use=${profile_dir} -Wno-missing-profile")
+        if(VCPKG_DETECTED_CMAKE_CXX_COMPILER_VERSION VERSION_GREATER_EQUAL "10")
+            # Keeps the code which the training did not run optimized for speed, instead of for size.
+            string(APPEND use_flags " -fprofile-partial-training")
+        endif()
+    else()
+        set(use_flags "-fprofile-instr-use=${profile_dir}/default.profdata -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date")
+    endif()
+
+    if(EXISTS "${profile_dir}")
+        message(STATUS "Using the stored PGO profile of ${PORT}")
+    else()
+        z_vcpkg_cmake_pgo_train()
+    endif()
+
+    set(VCPKG_C_FLAGS_RELEASE "${VCPKG_C_FLAGS_RELEASE} ${use_flags}")
+    set(VCPKG_CXX_FLAGS_RELEASE "${VCPKG_CXX_FLAGS_RELEASE} ${use_flags}")
+    vcpkg_cmake_configure(${configure_args} ${configure_options})
+endfunction()
+
+# Builds the instrumented release build, runs the training script and stores the profile in profile_dir.
+# Only called by vcpkg_cmake_pgo, whose variables it uses.
+macro(z_vcpkg_cmake_pgo_train)
+    set(z_vcpkg_pgo_data_dir "${CURRENT_BUILDTREES_DIR}/pgo-${TARGET_TRIPLET}")
+    file(REMOVE_RECURSE "${z_vcpkg_pgo_data_dir}")
+    file(MAKE_DIRECTORY "${z_vcpkg_pgo_data_dir}")
+    if(compiler_id STREQUAL "GNU")
+        set(z_vcpkg_pgo_generate_flags "-fprofile-generate=${z_vcpkg_pgo_data_dir} -fprofile-update=prefer-atomic")
+    else()
+        z_vcpkg_cmake_pgo_find_profdata(z_vcpkg_pgo_profdata "${VCPKG_DETECTED_CMAKE_CXX_COMPILER}")
+        if(NOT z_vcpkg_pgo_profdata)
+            message(FATAL_ERROR "Could not find llvm-profdata, which is required to build ${PORT} with VCPKG_PGO and clang.")
+        endif()
+        set(z_vcpkg_pgo_generate_flags "-fprofile-instr-generate=${z_vcpkg_pgo_data_dir}/vcpkg-%m.profraw")
+    endif()
+
+    # The instrumented build is configured in place of the release build, which is configured again afterwards.
+    set(z_vcpkg_pgo_saved_build_type "${VCPKG_BUILD_TYPE}")
+    set(z_vcpkg_pgo_saved_c_flags "${VCPKG_C_FLAGS_RELEASE}")
+    set(z_vcpkg_pgo_saved_cxx_flags "${VCPKG_CXX_FLAGS_RELEASE}")
+    set(z_vcpkg_pgo_saved_linker_flags "${VCPKG_LINKER_FLAGS_RELEASE}")
+    set(VCPKG_BUILD_TYPE release)
+    set(VCPKG_C_FLAGS_RELEASE "${VCPKG_C_FLAGS_RELEASE} ${z_vcpkg_pgo_generate_flags}")
+    set(VCPKG_CXX_FLAGS_RELEASE "${VCPKG_CXX_FLAGS_RELEASE} ${z_vcpkg_pgo_generate_flags}")
+    set(VCPKG_LINKER_FLAGS_RELEASE "${VCPKG_LINKER_FLAGS_RELEASE} ${z_vcpkg_pgo_generate_flags}")
+
+    message(STATUS "Building an instrumented ${PORT} for profile-guided optimization")
+    vcpkg_cmake_configure(${configure_args}
+        LOGFILE_BASE "config-pgo"
+        OPTIONS ${arg_OPTIONS}
+        OPTIONS_RELEASE ${arg_OPTIONS_RELEASE} ${arg_OPTIONS_TRAINING}
+    )
+    vcpkg_cmake_build(LOGFILE_BASE "build-pgo")
+
+    message(STATUS "Running the PGO training of ${PORT}")
+    set(PGO_BUILD_DIR "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel")
+    set(SOURCE_PATH "${arg_SOURCE_PATH}")
+    z_vcpkg_trace_begin("pgo_training" CATEGORY build)
+    include("${training_script}")
+    z_vcpkg_trace_end("pgo_training" CATEGORY build)
+
+    set(VCPKG_BUILD_TYPE "${z_vcpkg_pgo_saved_build_type}")
+    if(VCPKG_BUILD_TYPE STREQUAL "")
+        unset(VCPKG_BUILD_TYPE)
+    endif()
+    set(VCPKG_C_FLAGS_RELEASE "${z_vcpkg_pgo_saved_c_flags}")
+    set(VCPKG_CXX_FLAGS_RELEASE "${z_vcpkg_pgo_saved_cxx_flags}")
+    set(VCPKG_LINKER_FLAGS_RELEASE "${z_vcpkg_pgo_saved_linker_flags}")
+    unset(Z_VCPKG_CMAKE_GENERATOR CACHE)
+
+    file(GLOB_RECURSE z_vcpkg_pgo_data LIST_DIRECTORIES false "${z_vcpkg_pgo_data_dir}/*")
+    if(z_vcpkg_pgo_data STREQUAL "")
+        message(FATAL_ERROR "The PGO training of ${PORT} did not write any profile data to ${z_vcpkg_pgo_data_dir}.")
+    endif()
+
+    # Concurrent builds may store the same profile; write to a temporary directory so that readers never see a partial one.
+    string(RANDOM LENGTH 8 z_vcpkg_pgo_suffix)
+    set(z_vcpkg_pgo_temp_dir "${profile_dir}.${z_vcpkg_pgo_suffix}.tmp")
+    file(MAKE_DIRECTORY "${z_vcpkg_pgo_temp_dir}")
+    if(compiler_id STREQUAL "GNU")
+        file(COPY "${z_vcpkg_pgo_data_dir}/" DESTINATION "${z_vcpkg_pgo_temp_dir}")
+    else()
+        vcpkg_execute_required_process(
+            COMMAND "${z_vcpkg_pgo_profdata}" merge "-output=${z_vcpkg_pgo_temp_dir}/default.profdata" ${z_vcpkg_pgo_data}
+            WORKING_DIRECTORY "${z_vcpkg_pgo_data_dir}"
+            LOGNAME "pgo-merge-${TARGET_TRIPLET}"
+        )
+    endif()
+    if(EXISTS "${profile_dir}")
+        file(REMOVE_RECURSE "${z_vcpkg_pgo_temp_dir}")
+    else()
+        file(RENAME "${z_vcpkg_pgo_temp_dir}" "${profile_dir}")
+    endif()
+endmacro()
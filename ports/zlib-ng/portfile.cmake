@@ -0,0 +1,75 @@
+vcpkg_from_github(
+    OUT_SOURCE_PATH SOURCE_PATH
+    REPO zlib-ng/zlib-ng
+    REF 2.0.2
+    SHA512 0
+    HEAD_REF develop
+)
+
+if("zlib-compat" IN_LIST FEATURES)
+    set(ZLIB_COMPAT ON)
+else()
+    set(ZLIB_COMPAT OFF)
+endif()
+
+# The optimized code paths for SSE2, SSSE3, SSE4.2, PCLMULQDQ and AVX2 (or NEON on ARM)
+# are selected at runtime for the CPU the library runs on.
+vcpkg_cmake_configure(
+    SOURCE_PATH "${SOURCE_PATH}"
+    OPTIONS
+        -DZLIB_COMPAT=${ZLIB_COMPAT}
+        -DZLIB_ENABLE_TESTS=OFF
+        -DWITH_GZFILEOP=ON
+        -DWITH_NATIVE_INSTRUCTIONS=OFF
+    OPTIONS_DEBUG
+        -DSKIP_INSTALL_HEADERS=ON
+)
+
+vcpkg_cmake_install()
+vcpkg_copy_pdbs()
+
+if(ZLIB_COMPAT AND VCPKG_TARGET_IS_WINDOWS AND NOT VCPKG_TARGET_IS_MINGW)
+    # Consumers of the zlib port hard-code its library names, zlib.lib and zlibd.lib (e.g. boost's ZLIB_BINARY).
+    foreach(buildtype IN ITEMS release debug)
+        if(buildtype STREQUAL "release")
+            set(libdir "${CURRENT_PACKAGES_DIR}/lib")
+            set(zlib_name zlib)
+            set(other_names zlibstatic)
+        else()
+            set(libdir "${CURRENT_PACKAGES_DIR}/debug/lib")
+            set(zlib_name zlibd)
+            set(other_names zlibstaticd zlibstatic zlib)
+        endif()
+        if(NOT EXISTS "${libdir}")
+            continue()
+        endif()
+        if(NOT EXISTS "${libdir}/${zlib_name}.lib")
+            foreach(name IN LISTS other_names)
+                if(EXISTS "${libdir}/${name}.lib")
+                    file(RENAME "${libdir}/${name}.lib" "${libdir}/${zlib_name}.lib")
+                    break()
+                endif()
+            endforeach()
+        endif()
+        if(NOT EXISTS "${libdir}/${zlib_name}.lib")
+            file(GLOB libraries RELATIVE "${libdir}" "${libdir}/*.lib")
+            message(FATAL_ERROR "zlib-ng did not install ${zlib_name}.lib in ${libdir}; found: ${libraries}")
+        endif()
+        if(EXISTS "${libdir}/pkgconfig/zlib.pc")
+            file(READ "${libdir}/pkgconfig/zlib.pc" zlib_pc)
+            string(REGEX REPLACE "-lz(lib|libstatic)?d?([ \t\r\n]|$)" "-l${zlib_name}\\2" zlib_pc "${zlib_pc}")
+            file(WRITE "${libdir}/pkgconfig/zlib.pc" "${zlib_pc}")
+        endif()
+    endforeach()
+endif()
+
+vcpkg_fixup_pkgconfig()
+
+file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/debug/include" "${CURRENT_PACKAGES_DIR}/debug/share" "${CURRENT_PACKAGES_DIR}/share/man")
+
+if(ZLIB_COMPAT)
+    file(INSTALL "${CMAKE_CURRENT_LIST_DIR}/usage-zlib-compat" DESTINATION "${CURRENT_PACKAGES_DIR}/share/${PORT}" RENAME usage)
+else()
+    file(INSTALL "${CMAKE_CURRENT_LIST_DIR}/usage" DESTINATION "${CURRENT_PACKAGES_DIR}/share/${PORT}")
+endif()
+file(INSTALL "${SOURCE_PATH}/LICENSE.md" DESTINATION "${CURRENT_PACKAGES_DIR}/share/${PORT}" RENAME copyright)
@@ -1,3 +1,9 @@
+if("zlib-ng" IN_LIST FEATURES)
+    # zlib-ng[zlib-compat] installs the headers, libraries and pkg-config file of zlib.
+    set(VCPKG_POLICY_EMPTY_PACKAGE enabled)
+    return()
+endif()
+
 set(VERSION 1.2.11)
 
 vcpkg_download_distfile(ARCHIVE_FILE
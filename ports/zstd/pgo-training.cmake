@@ -0,0 +1,6 @@
+# Trains the library on the built-in benchmark of the zstd program, which compresses and decompresses generated data.
+vcpkg_execute_required_process(
+    COMMAND "${PGO_BUILD_DIR}/programs/zstd" -b1e9 -i1
+    WORKING_DIRECTORY "${PGO_BUILD_DIR}"
+    LOGNAME "pgo-training-${TARGET_TRIPLET}"
+)
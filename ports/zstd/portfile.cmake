@@ -16,16 +16,22 @@ else()
     set(ZSTD_SHARED 1)
 endif()
 
-if(VCPKG_TARGET_IS_WINDOWS)
+if("multithread" IN_LIST FEATURES)
     # Enable multithreaded mode. CMake build doesn't provide a multithreaded
     # library target, but it is the default in Makefile and VS projects.
     set(VCPKG_C_FLAGS "${VCPKG_C_FLAGS} -DZSTD_MULTITHREAD")
     set(VCPKG_CXX_FLAGS "${VCPKG_CXX_FLAGS}")
+    if(NOT VCPKG_TARGET_IS_WINDOWS)
+        # Worker threads use pthreads outside of Windows.
+        set(ZSTD_LINK_PTHREADS 1)
+        set(VCPKG_C_FLAGS "${VCPKG_C_FLAGS} -pthread")
+        set(VCPKG_LINKER_FLAGS "${VCPKG_LINKER_FLAGS} -pthread")
+    endif()
 endif()
 
-vcpkg_configure_cmake(
+vcpkg_cmake_pgo(
     SOURCE_PATH ${SOURCE_PATH}/build/cmake
-    PREFER_NINJA
+    TRAINING_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/pgo-training.cmake"
     OPTIONS
         -DZSTD_BUILD_SHARED=${ZSTD_SHARED}
         -DZSTD_BUILD_STATIC=${ZSTD_STATIC}
@@ -34,17 +40,30 @@ vcpkg_configure_cmake(
         -DZSTD_BUILD_TESTS=0
         -DZSTD_BUILD_CONTRIB=0
     OPTIONS_DEBUG
-        -DCMAKE_DEBUG_POSTFIX=d) # this is against the maintainer guidelines. 
+        -DCMAKE_DEBUG_POSTFIX=d # this is against the maintainer guidelines. 
         # Removing it probably requires a vcpkg-cmake-wrapper.cmake to correct downstreams FindZSTD.cmake
+    OPTIONS_TRAINING
+        -DZSTD_BUILD_PROGRAMS=1
+)
 
-vcpkg_install_cmake()
+vcpkg_cmake_install()
 vcpkg_copy_pdbs()
-vcpkg_fixup_cmake_targets(CONFIG_PATH lib/cmake/zstd)
+vcpkg_cmake_config_fixup(CONFIG_PATH lib/cmake/zstd)
 
 # This enables find_package(ZSTD) and find_package(zstd) to find zstd on Linux(case sensitive filesystems)
 file(RENAME "${CURRENT_PACKAGES_DIR}/share/${PORT}/zstdConfig.cmake" "${CURRENT_PACKAGES_DIR}/share/${PORT}/zstd-config.cmake")
 file(RENAME "${CURRENT_PACKAGES_DIR}/share/${PORT}/zstdConfigVersion.cmake" "${CURRENT_PACKAGES_DIR}/share/${PORT}/zstd-configVersion.cmake")
 
+if(ZSTD_LINK_PTHREADS)
+    # The static library needs pthreads; the CMake build of zstd does not export this dependency.
+    vcpkg_add_find_dependency(
+        CONFIG_FILE "${CURRENT_PACKAGES_DIR}/share/${PORT}/zstd-config.cmake"
+        FIND_DEPENDENCY Threads
+        TARGETS zstd::libzstd_static
+        LINK_LIBRARIES Threads::Threads
+    )
+endif()
+
 if(VCPKG_LIBRARY_LINKAGE STREQUAL "static" AND VCPKG_TARGET_IS_WINDOWS)
     set(static_suffix "_static")
 else()
@@ -56,6 +75,9 @@ endif()
 if(EXISTS "${CURRENT_PACKAGES_DIR}/debug/lib/pkgconfig/libzstd.pc")
     vcpkg_replace_string("${CURRENT_PACKAGES_DIR}/debug/lib/pkgconfig/libzstd.pc" "-lzstd" "-lzstd${static_suffix}d")
 endif()
+if(ZSTD_LINK_PTHREADS)
+    vcpkg_add_pkgconfig_libs_private(NAME libzstd LIBS -pthread)
+endif()
 
 vcpkg_fixup_pkgconfig()
 
@@ -38,3 +38,10 @@ endif()
 if (DEFINED VCPKG_HEAD_VERSION)
     file(APPEND ${BUILD_INFO_FILE_PATH} "Version: ${VCPKG_HEAD_VERSION}\n")
 endif()
+
+# Resource usage is informational; it is written as comments so that vcpkg does not parse it as fields.
+z_vcpkg_resource_usage_summarize(resource_usage)
+if(NOT resource_usage STREQUAL "")
+    string(REGEX REPLACE "([^\n]+)\n" "# \\1\n" resource_usage "${resource_usage}")
+    file(APPEND ${BUILD_INFO_FILE_PATH} "${resource_usage}")
+endif()
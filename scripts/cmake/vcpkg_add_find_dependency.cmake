@@ -0,0 +1,67 @@
+#[===[.md:
+# vcpkg_add_find_dependency
+
+Make an installed CMake config file find a dependency which the build of the port does not export,
+and add it to the link interface of the imported targets.
+
+## Usage
+```cmake
+vcpkg_add_find_dependency(
+    CONFIG_FILE <${CURRENT_PACKAGES_DIR}/share/${PORT}/${PORT}-config.cmake>
+    FIND_DEPENDENCY <package> [<find_dependency() arguments>...]
+    [TARGETS <target>...]
+    [LINK_LIBRARIES <library>...]
+)
+```
+
+## Parameters
+### CONFIG_FILE
+The installed config file. `find_dependency()` is added before its contents.
+
+### FIND_DEPENDENCY
+The arguments of `find_dependency()`.
+
+### TARGETS
+The imported targets which need the dependency. Targets which the config file does not define are skipped.
+
+### LINK_LIBRARIES
+The libraries appended to the `INTERFACE_LINK_LIBRARIES` of `TARGETS`.
+
+## Notes
+Calling this function again with the same `FIND_DEPENDENCY` does not change the config file.
+
+## Examples
+
+* [openblas](https://github.com/microsoft/vcpkg/blob/master/ports/openblas/portfile.cmake)
+* [zstd](https://github.com/microsoft/vcpkg/blob/master/ports/zstd/portfile.cmake)
+#]===]
+
+function(vcpkg_add_find_dependency)
+    cmake_parse_arguments(PARSE_ARGV 0 _vafd "" "CONFIG_FILE" "FIND_DEPENDENCY;TARGETS;LINK_LIBRARIES")
+
+    if(NOT DEFINED _vafd_CONFIG_FILE OR NOT DEFINED _vafd_FIND_DEPENDENCY)
+        message(FATAL_ERROR "CONFIG_FILE and FIND_DEPENDENCY must be specified.")
+    endif()
+    if(DEFINED _vafd_TARGETS AND NOT DEFINED _vafd_LINK_LIBRARIES)
+        message(FATAL_ERROR "TARGETS requires LINK_LIBRARIES.")
+    endif()
+
+    list(JOIN _vafd_FIND_DEPENDENCY " " _find_dependency)
+    set(_find_dependency "find_dependency(${_find_dependency})")
+    file(READ "${_vafd_CONFIG_FILE}" _contents)
+    string(FIND "${_contents}" "${_find_dependency}" _index)
+    if(NOT _index EQUAL -1)
+        return()
+    endif()
+
+    string(STRIP "${_contents}" _contents)
+    set(_link "")
+    if(DEFINED _vafd_TARGETS)
+        list(JOIN _vafd_LINK_LIBRARIES " " _libraries)
+        foreach(_target IN LISTS _vafd_TARGETS)
+            string(APPEND _link "if(TARGET ${_target})\n    set_property(TARGET ${_target} APPEND PROPERTY INTERFACE_LINK_LIBRARIES ${_libraries})\nendif()\n")
+        endforeach()
+    endif()
+
+    file(WRITE "${_vafd_CONFIG_FILE}" "include(CMakeFindDependencyMacro)\n${_find_dependency}\n${_contents}\n${_link}")
+endfunction()
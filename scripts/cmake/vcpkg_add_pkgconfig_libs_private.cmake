@@ -0,0 +1,57 @@
+#[===[.md:
+# vcpkg_add_pkgconfig_libs_private
+
+Append flags to the `Libs.private` field of the release and debug pkg-config files of a port.
+
+## Usage
+```cmake
+vcpkg_add_pkgconfig_libs_private(
+    NAME <name>
+    LIBS <flag>...
+)
+```
+
+## Parameters
+### NAME
+The name of the pkg-config file, without `.pc`. Files which are missing in `lib/pkgconfig` or `debug/lib/pkgconfig` are skipped.
+
+### LIBS
+The flags to append, such as `-pthread` or `-lm`. Flags which `Libs.private` already contains are not added again.
+
+## Notes
+Call this function before [`vcpkg_fixup_pkgconfig()`](vcpkg_fixup_pkgconfig.md), which validates the result.
+
+## Examples
+
+* [openblas](https://github.com/microsoft/vcpkg/blob/master/ports/openblas/portfile.cmake)
+* [zstd](https://github.com/microsoft/vcpkg/blob/master/ports/zstd/portfile.cmake)
+#]===]
+
+function(vcpkg_add_pkgconfig_libs_private)
+    cmake_parse_arguments(PARSE_ARGV 0 _vapl "" "NAME" "LIBS")
+
+    if(NOT DEFINED _vapl_NAME OR NOT DEFINED _vapl_LIBS)
+        message(FATAL_ERROR "NAME and LIBS must be specified.")
+    endif()
+
+    foreach(_pc IN ITEMS "${CURRENT_PACKAGES_DIR}/lib/pkgconfig/${_vapl_NAME}.pc" "${CURRENT_PACKAGES_DIR}/debug/lib/pkgconfig/${_vapl_NAME}.pc")
+        if(NOT EXISTS "${_pc}")
+            continue()
+        endif()
+        file(READ "${_pc}" _contents)
+        string(STRIP "${_contents}" _contents)
+        if(NOT _contents MATCHES "(^|\n)Libs.private:")
+            string(APPEND _contents "\nLibs.private:")
+        endif()
+        string(REGEX MATCH "(^|\n)Libs.private:[^\n]*" _libs_private "${_contents}")
+        string(REGEX REPLACE "[ \t]+" ";" _present "${_libs_private}")
+        set(_append "")
+        foreach(_lib IN LISTS _vapl_LIBS)
+            if(NOT _lib IN_LIST _present)
+                string(APPEND _append " ${_lib}")
+            endif()
+        endforeach()
+        string(REPLACE "${_libs_private}" "${_libs_private}${_append}" _contents "${_contents}")
+        file(WRITE "${_pc}" "${_contents}\n")
+    endforeach()
+endfunction()
@@ -11,7 +11,8 @@ vcpkg_build_cmake([DISABLE_PARALLEL] [TARGET <target>])
 
 ## Parameters:
 ### DISABLE_PARALLEL
-The underlying buildsystem will be instructed to not parallelize
+The underlying buildsystem will be instructed to not parallelize.
+Otherwise, if the triplet sets `VCPKG_CONCURRENT_BUILD_TYPES`, the debug and release builds run at the same time.
 
 ### TARGET
 The target passed to the cmake build command (`cmake --build . --target <target>`). If not specified, no target will
@@ -51,16 +52,18 @@ function(vcpkg_build_cmake)
     set(PARALLEL_ARG)
     set(NO_PARALLEL_ARG)
 
+    z_vcpkg_concurrent_build_begin(JOBS)
+
     if(Z_VCPKG_CMAKE_GENERATOR MATCHES "Ninja")
         set(BUILD_ARGS "-v") # verbose output
-        set(PARALLEL_ARG "-j${VCPKG_CONCURRENCY}")
+        set(PARALLEL_ARG "-j${JOBS}")
         set(NO_PARALLEL_ARG "-j1")
     elseif(Z_VCPKG_CMAKE_GENERATOR MATCHES "Visual Studio")
         set(BUILD_ARGS
             "/p:VCPkgLocalAppDataDisabled=true"
             "/p:UseIntelMKL=No"
         )
-        set(PARALLEL_ARG "/m")
+        set(PARALLEL_ARG "/m:${JOBS}")
     elseif(Z_VCPKG_CMAKE_GENERATOR MATCHES "NMake")
         # No options are currently added for nmake builds
     else()
@@ -101,9 +104,11 @@ function(vcpkg_build_cmake)
                     LOGNAME "${arg_LOGFILE_ROOT}-${TARGET_TRIPLET}-${SHORT_BUILDTYPE}"
                 )
             else()
-                vcpkg_execute_build_process(
+                z_vcpkg_concurrent_build_add(
+                    BUILD_TYPE ${BUILDTYPE}
                     COMMAND ${CMAKE_COMMAND} --build . --config ${CONFIG} ${TARGET_PARAM} -- ${BUILD_ARGS} ${PARALLEL_ARG}
                     NO_PARALLEL_COMMAND ${CMAKE_COMMAND} --build . --config ${CONFIG} ${TARGET_PARAM} -- ${BUILD_ARGS} ${NO_PARALLEL_ARG}
+                    JOBS ${JOBS}
                     WORKING_DIRECTORY ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
                     LOGNAME "${arg_LOGFILE_ROOT}-${TARGET_TRIPLET}-${SHORT_BUILDTYPE}"
                 )
@@ -114,4 +119,6 @@ function(vcpkg_build_cmake)
             endif()
         endif()
     endforeach()
+
+    z_vcpkg_concurrent_build_end()
 endfunction()
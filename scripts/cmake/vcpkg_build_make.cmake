@@ -32,7 +32,8 @@ The target passed to the make build command (`./make <target>`). Defaults to 'al
 The target passed to the make build command (`./make <target>`) if `ENABLE_INSTALL` is used. Defaults to 'install'.
 
 ### DISABLE_PARALLEL
-The underlying buildsystem will be instructed to not parallelize
+The underlying buildsystem will be instructed to not parallelize.
+Otherwise, if the triplet sets `VCPKG_CONCURRENT_BUILD_TYPES`, the debug and release builds run at the same time.
 
 ### SUBPATH
 Additional subdir to invoke make in. Useful if only parts of a port should be built. 
@@ -84,6 +85,12 @@ function(vcpkg_build_make)
         string(REPLACE " " "\ " _VCPKG_INSTALLED "${CURRENT_INSTALLED_DIR}")
     endif()
 
+    if(_VCPKG_NO_DEBUG OR _bc_DISABLE_PARALLEL)
+        z_vcpkg_concurrent_build_begin(JOBS DISABLE)
+    else()
+        z_vcpkg_concurrent_build_begin(JOBS)
+    endif()
+
     set(MAKE )
     set(MAKE_OPTS )
     set(INSTALL_OPTS )
@@ -93,12 +100,12 @@ function(vcpkg_build_make)
         vcpkg_acquire_msys(MSYS_ROOT)
         find_program(MAKE make REQUIRED)
         set(MAKE_COMMAND "${MAKE}")
-        set(MAKE_OPTS ${_bc_MAKE_OPTIONS} -j ${VCPKG_CONCURRENCY} --trace -f ${_bc_MAKEFILE} ${_bc_BUILD_TARGET})
+        set(MAKE_OPTS ${_bc_MAKE_OPTIONS} -j ${JOBS} --trace -f ${_bc_MAKEFILE} ${_bc_BUILD_TARGET})
         set(NO_PARALLEL_MAKE_OPTS ${_bc_MAKE_OPTIONS} -j 1 --trace -f ${_bc_MAKEFILE} ${_bc_BUILD_TARGET})
 
         string(REPLACE " " "\\\ " _VCPKG_PACKAGE_PREFIX ${CURRENT_PACKAGES_DIR})
         string(REGEX REPLACE "([a-zA-Z]):/" "/\\1/" _VCPKG_PACKAGE_PREFIX "${_VCPKG_PACKAGE_PREFIX}")
-        set(INSTALL_OPTS -j ${VCPKG_CONCURRENCY} --trace -f ${_bc_MAKEFILE} ${_bc_INSTALL_TARGET} DESTDIR=${_VCPKG_PACKAGE_PREFIX})
+        set(INSTALL_OPTS -j ${JOBS} --trace -f ${_bc_MAKEFILE} ${_bc_INSTALL_TARGET} DESTDIR=${_VCPKG_PACKAGE_PREFIX})
         #TODO: optimize for install-data (release) and install-exec (release/debug)
     else()
         # Compiler requriements
@@ -109,13 +116,15 @@ function(vcpkg_build_make)
         endif()
         set(MAKE_COMMAND "${MAKE}")
         # Set make command and install command
-        set(MAKE_OPTS ${_bc_MAKE_OPTIONS} V=1 -j ${VCPKG_CONCURRENCY} -f ${_bc_MAKEFILE} ${_bc_BUILD_TARGET})
+        set(MAKE_OPTS ${_bc_MAKE_OPTIONS} V=1 -j ${JOBS} -f ${_bc_MAKEFILE} ${_bc_BUILD_TARGET})
         set(NO_PARALLEL_MAKE_OPTS ${_bc_MAKE_OPTIONS} V=1 -j 1 -f ${_bc_MAKEFILE} ${_bc_BUILD_TARGET})
-        set(INSTALL_OPTS -j ${VCPKG_CONCURRENCY} -f ${_bc_MAKEFILE} ${_bc_INSTALL_TARGET} DESTDIR=${CURRENT_PACKAGES_DIR})
+        set(INSTALL_OPTS -j ${JOBS} -f ${_bc_MAKEFILE} ${_bc_INSTALL_TARGET} DESTDIR=${CURRENT_PACKAGES_DIR})
     endif()
 
     # Since includes are buildtype independent those are setup by vcpkg_configure_make
     _vcpkg_backup_env_variables(LIB LIBPATH LIBRARY_PATH LD_LIBRARY_PATH)
+    set(BUILD_ENV_VARS CPPFLAGS CFLAGS CXXFLAGS RCFLAGS LDFLAGS LIB LIBPATH LIBRARY_PATH _LINK_)
+    set(BUILD_LOGS )
 
     foreach(BUILDTYPE "debug" "release")
         if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL BUILDTYPE)
@@ -191,18 +200,17 @@ function(vcpkg_build_make)
                         LOGNAME "${_bc_LOGFILE_ROOT}-${TARGET_TRIPLET}${SHORT_BUILDTYPE}"
                 )
             else()
-                vcpkg_execute_build_process(
+                z_vcpkg_concurrent_build_add(
+                        BUILD_TYPE ${BUILDTYPE}
                         COMMAND ${MAKE_BASH} ${MAKE_CMD_LINE}
                         NO_PARALLEL_COMMAND ${MAKE_BASH} ${NO_PARALLEL_MAKE_CMD_LINE}
+                        JOBS ${JOBS}
                         WORKING_DIRECTORY "${WORKING_DIRECTORY}"
                         LOGNAME "${_bc_LOGFILE_ROOT}-${TARGET_TRIPLET}${SHORT_BUILDTYPE}"
+                        ENVIRONMENT ${BUILD_ENV_VARS}
                 )
             endif()
-
-            file(READ "${CURRENT_BUILDTREES_DIR}/${_bc_LOGFILE_ROOT}-${TARGET_TRIPLET}${SHORT_BUILDTYPE}-out.log" LOGDATA) 
-            if(LOGDATA MATCHES "Warning: linker path does not have real file for library")
-                message(FATAL_ERROR "libtool could not find a file being linked against!")
-            endif()
+            list(APPEND BUILD_LOGS "${CURRENT_BUILDTREES_DIR}/${_bc_LOGFILE_ROOT}-${TARGET_TRIPLET}${SHORT_BUILDTYPE}-out.log")
 
             if (_bc_ENABLE_INSTALL)
                 message(STATUS "Installing ${TARGET_TRIPLET}${SHORT_BUILDTYPE}")
@@ -211,10 +219,13 @@ function(vcpkg_build_make)
                 else()
                     set(MAKE_CMD_LINE ${MAKE_COMMAND} ${INSTALL_OPTS})
                 endif()
-                vcpkg_execute_build_process(
+                z_vcpkg_concurrent_build_add(
+                    BUILD_TYPE ${BUILDTYPE}
                     COMMAND ${MAKE_BASH} ${MAKE_CMD_LINE}
+                    JOBS ${JOBS}
                     WORKING_DIRECTORY "${WORKING_DIRECTORY}"
                     LOGNAME "install-${TARGET_TRIPLET}${SHORT_BUILDTYPE}"
+                    ENVIRONMENT ${BUILD_ENV_VARS}
                 )
             endif()
 
@@ -229,6 +240,15 @@ function(vcpkg_build_make)
         endif()
     endforeach()
 
+    z_vcpkg_concurrent_build_end()
+
+    foreach(BUILD_LOG IN LISTS BUILD_LOGS)
+        file(READ "${BUILD_LOG}" LOGDATA)
+        if(LOGDATA MATCHES "Warning: linker path does not have real file for library")
+            message(FATAL_ERROR "libtool could not find a file being linked against!")
+        endif()
+    endforeach()
+
     if (_bc_ENABLE_INSTALL)
         string(REGEX REPLACE "([a-zA-Z]):/" "/\\1/" _VCPKG_INSTALL_PREFIX "${CURRENT_INSTALLED_DIR}")
         file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}_tmp")
@@ -27,8 +27,13 @@ By convention, this is usually set in the portfile as the variable `SOURCE_PATH`
 Indicates that, when available, Vcpkg should use Ninja to perform the build.
 This should be specified unless the port is known to not work under Ninja.
 
+When Ninja is used, link steps run in a job pool
+sized to the available memory divided by `VCPKG_LINK_JOB_MEMORY`.
+Ports which set up their own job pools should pass `CMAKE_JOB_POOLS` or `CMAKE_JOB_POOL_LINK` in `OPTIONS`.
+
 ### DISABLE_PARALLEL_CONFIGURE
 Disables running the CMake configure step in parallel.
+By default, the debug and release builds are configured in parallel on every host where Ninja is available.
 This is needed for libraries which write back into their source directory during configure.
 
 This also disables CMAKE_DISABLE_SOURCE_CHANGES.
@@ -77,6 +82,7 @@ function(vcpkg_configure_cmake)
         "SOURCE_PATH;GENERATOR;LOGNAME"
         "OPTIONS;OPTIONS_DEBUG;OPTIONS_RELEASE"
     )
+    z_vcpkg_trace_begin("cmake_configure" CATEGORY configure)
 
     if(NOT VCPKG_PLATFORM_TOOLSET)
         message(FATAL_ERROR "Vcpkg has been updated with VS2017 support; "
@@ -269,6 +275,37 @@ function(vcpkg_configure_cmake)
         )
     endif()
 
+    # Set up by z_vcpkg_compiler_cache_begin when the triplet sets VCPKG_COMPILER_CACHE
+    foreach(_buildtype IN ITEMS DEBUG RELEASE)
+        if(DEFINED Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_buildtype})
+            list(APPEND arg_OPTIONS_${_buildtype} "-DVCPKG_COMPILER_CACHE_LAUNCHER=${Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_buildtype}}")
+        endif()
+    endforeach()
+
+    # Used by scripts/toolchains/linux.cmake
+    if(VCPKG_LTO)
+        list(APPEND arg_OPTIONS "-DVCPKG_LTO=${VCPKG_LTO}")
+    endif()
+    if(VCPKG_TARGET_ISA_LEVEL)
+        list(APPEND arg_OPTIONS "-DVCPKG_TARGET_ISA_LEVEL=${VCPKG_TARGET_ISA_LEVEL}")
+    endif()
+    if(VCPKG_LINKER)
+        list(APPEND arg_OPTIONS "-DVCPKG_LINKER=${VCPKG_LINKER}")
+    endif()
+
+    # Limit the number of concurrent link steps, which use much more memory than compiling
+    if(GENERATOR STREQUAL "Ninja" AND NOT arg_OPTIONS MATCHES "-DCMAKE_JOB_POOL")
+        if(VCPKG_CONCURRENT_BUILD_TYPES AND NOT DEFINED VCPKG_BUILD_TYPE)
+            z_vcpkg_get_build_jobs(LINK_JOBS LINK CONCURRENT_BUILDS 2)
+        else()
+            z_vcpkg_get_build_jobs(LINK_JOBS LINK)
+        endif()
+        list(APPEND arg_OPTIONS
+            "-DCMAKE_JOB_POOLS=vcpkg_link=${LINK_JOBS}"
+            "-DCMAKE_JOB_POOL_LINK=vcpkg_link"
+        )
+    endif()
+
     # Sets configuration variables for macOS builds
     foreach(config_var  INSTALL_NAME_DIR OSX_DEPLOYMENT_TARGET OSX_SYSROOT OSX_ARCHITECTURES)
         if(DEFINED VCPKG_${config_var})
@@ -287,7 +324,7 @@ function(vcpkg_configure_cmake)
         -DCMAKE_BUILD_TYPE=Debug
         -DCMAKE_INSTALL_PREFIX=${CURRENT_PACKAGES_DIR}/debug)
 
-    if(NINJA_HOST AND CMAKE_HOST_WIN32 AND NOT arg_DISABLE_PARALLEL_CONFIGURE)
+    if(NINJA_HOST AND NOT arg_DISABLE_PARALLEL_CONFIGURE)
         list(APPEND arg_OPTIONS "-DCMAKE_DISABLE_SOURCE_CHANGES=ON")
 
         vcpkg_find_acquire_program(NINJA)
@@ -299,12 +336,24 @@ function(vcpkg_configure_cmake)
             "rule CreateProcess\n  command = $process\n\n"
         )
 
+        # ninja uses CreateProcess on Windows and `/bin/sh -c` elsewhere
         macro(_build_cmakecache whereat build_type)
-            set(${build_type}_line "build ${whereat}/CMakeCache.txt: CreateProcess\n  process = cmd /c \"cd ${whereat} &&")
-            foreach(arg ${${build_type}_command})
-                set(${build_type}_line "${${build_type}_line} \"${arg}\"")
-            endforeach()
-            set(_contents "${_contents}${${build_type}_line}\"\n\n")
+            if(CMAKE_HOST_WIN32)
+                set(${build_type}_line "build ${whereat}/CMakeCache.txt: CreateProcess\n  process = cmd /c \"cd ${whereat} &&")
+                foreach(arg ${${build_type}_command})
+                    string(REPLACE "$" "$$" arg "${arg}")
+                    set(${build_type}_line "${${build_type}_line} \"${arg}\"")
+                endforeach()
+                set(_contents "${_contents}${${build_type}_line}\"\n\n")
+            else()
+                set(${build_type}_line "build ${whereat}/CMakeCache.txt: CreateProcess\n  process = cd '${whereat}' &&")
+                foreach(arg ${${build_type}_command})
+                    string(REPLACE "'" "'\\''" arg "${arg}")
+                    string(REPLACE "$" "$$" arg "${arg}")
+                    set(${build_type}_line "${${build_type}_line} '${arg}'")
+                endforeach()
+                set(_contents "${_contents}${${build_type}_line}\n\n")
+            endif()
         endmacro()
 
         if(NOT DEFINED VCPKG_BUILD_TYPE)
@@ -348,4 +397,5 @@ function(vcpkg_configure_cmake)
     endif()
 
     set(Z_VCPKG_CMAKE_GENERATOR "${GENERATOR}" PARENT_SCOPE)
+    z_vcpkg_trace_end("cmake_configure" CATEGORY configure)
 endfunction()
@@ -81,6 +81,11 @@ List of additional environment variables to pass via the configure call.
 ## Notes
 This command supplies many common arguments to configure. To see the full list, examine the source.
 
+If the triplet sets `VCPKG_AUTOCONF_CACHE`, configure scripts generated by autoconf get a `config.cache`
+seeded from a cache shared by all ports of the triplet with the same compilers and flags,
+and the results of checks that only depend on those are added to the shared cache afterwards.
+See [`VCPKG_AUTOCONF_CACHE`](../users/triplets.md#VCPKG_AUTOCONF_CACHE) for details.
+
 ## Examples
 
 * [x264](https://github.com/Microsoft/vcpkg/blob/master/ports/x264/portfile.cmake)
@@ -227,6 +232,156 @@ macro(_vcpkg_extract_cpp_flags_and_set_cflags_and_cxxflags _SUFFIX)
     debug_message("CXXFLAGS_${_SUFFIX}: ${CXXFLAGS_${_SUFFIX}}")
 endmacro()
 
+# Returns the shared autoconf cache file for a configure script, or an empty string if it should not use one.
+# Only scripts generated by autoconf use the cache. The name of the cache file is derived from the detected compilers,
+# the flags in the environment and key_data, which must hold everything else that the shared checks depend on,
+# so that incompatible configurations never mix.
+function(_vcpkg_autoconf_cache_get_file out_var configure_script key_data)
+    set(${out_var} "" PARENT_SCOPE)
+    if(NOT DEFINED VCPKG_AUTOCONF_CACHE AND DEFINED ENV{VCPKG_AUTOCONF_CACHE})
+        set(VCPKG_AUTOCONF_CACHE "$ENV{VCPKG_AUTOCONF_CACHE}")
+    endif()
+    if(NOT DEFINED VCPKG_AUTOCONF_CACHE_DIR AND DEFINED ENV{VCPKG_AUTOCONF_CACHE_DIR})
+        set(VCPKG_AUTOCONF_CACHE_DIR "$ENV{VCPKG_AUTOCONF_CACHE_DIR}")
+    endif()
+    if(NOT VCPKG_AUTOCONF_CACHE OR NOT EXISTS "${configure_script}")
+        return()
+    endif()
+    file(STRINGS "${configure_script}" _generated LIMIT_COUNT 1 REGEX "Generated by GNU Autoconf")
+    if(NOT _generated)
+        return()
+    endif()
+    if(NOT VCPKG_AUTOCONF_CACHE_DIR)
+        set(VCPKG_AUTOCONF_CACHE_DIR "${DOWNLOADS}/autoconf-cache")
+    endif()
+    file(TO_CMAKE_PATH "${VCPKG_AUTOCONF_CACHE_DIR}" _cache_dir)
+    set(_key_data "${VCPKG_TARGET_ARCHITECTURE}|${VCPKG_LIBRARY_LINKAGE}|${VCPKG_CRT_LINKAGE}")
+    foreach(_lang IN ITEMS C CXX)
+        string(APPEND _key_data "|${VCPKG_DETECTED_CMAKE_${_lang}_COMPILER}|${VCPKG_DETECTED_CMAKE_${_lang}_COMPILER_ID}|${VCPKG_DETECTED_CMAKE_${_lang}_COMPILER_VERSION}")
+    endforeach()
+    foreach(_flags IN ITEMS CPPFLAGS CFLAGS CXXFLAGS LDFLAGS LIBS)
+        string(APPEND _key_data "|$ENV{${_flags}}")
+    endforeach()
+    string(SHA512 _key "${_key_data}|${key_data}")
+    string(SUBSTRING "${_key}" 0 32 _key)
+    set(${out_var} "${_cache_dir}/${TARGET_TRIPLET}-${_key}.cache" PARENT_SCOPE)
+endfunction()
+
+# Copies the shared autoconf cache to <dir>/config.cache, if it exists.
+function(_vcpkg_autoconf_cache_seed shared_file dir)
+    file(REMOVE "${dir}/config.cache")
+    get_filename_component(_cache_dir "${shared_file}" DIRECTORY)
+    file(MAKE_DIRECTORY "${_cache_dir}")
+    file(LOCK "${shared_file}.lock" GUARD FUNCTION)
+    if(EXISTS "${shared_file}")
+        file(COPY "${shared_file}" DESTINATION "${dir}")
+        get_filename_component(_name "${shared_file}" NAME)
+        file(RENAME "${dir}/${_name}" "${dir}/config.cache")
+    endif()
+endfunction()
+
+# Reads the entries of an autoconf cache file into <prefix>_NAMES and <prefix>_ENTRY_<name>,
+# and the names marked as conflicting into <prefix>_CONFLICTS.
+function(_vcpkg_autoconf_cache_read prefix cache_file)
+    set(_names)
+    set(_conflicts)
+    if(EXISTS "${cache_file}")
+        file(READ "${cache_file}" _contents)
+        # Values may contain semicolons; keep them out of the list handling.
+        string(ASCII 1 _semicolon)
+        string(REPLACE ";" "${_semicolon}" _contents "${_contents}")
+        string(REPLACE "\n" ";" _lines "${_contents}")
+        foreach(_line IN LISTS _lines)
+            string(REPLACE "${_semicolon}" ";" _line "${_line}")
+            if(_line MATCHES "^# vcpkg-conflict: ([A-Za-z0-9_]+)$")
+                list(APPEND _conflicts "${CMAKE_MATCH_1}")
+                continue()
+            elseif(_line MATCHES "^([A-Za-z_][A-Za-z0-9_]*)=\\$\\{[A-Za-z0-9_]+=.*\\}$")
+                set(_name "${CMAKE_MATCH_1}")
+            elseif(_line MATCHES "^test \"\\$\\{([A-Za-z_][A-Za-z0-9_]*)\\+set\\}\" = set \\|\\| [A-Za-z0-9_]+=")
+                set(_name "${CMAKE_MATCH_1}")
+            else()
+                continue()
+            endif()
+            # Skip values which span several lines
+            string(REGEX MATCHALL "'" _quotes "${_line}")
+            list(LENGTH _quotes _quote_count)
+            math(EXPR _quote_count "${_quote_count} % 2")
+            if(_quote_count)
+                continue()
+            endif()
+            list(APPEND _names "${_name}")
+            set(${prefix}_ENTRY_${_name} "${_line}" PARENT_SCOPE)
+        endforeach()
+    endif()
+    set(${prefix}_NAMES "${_names}" PARENT_SCOPE)
+    set(${prefix}_CONFLICTS "${_conflicts}" PARENT_SCOPE)
+endfunction()
+
+# Adds the results of a successful configure run to the shared autoconf cache.
+# Only checks which depend on nothing but the compiler, the flags and the C library are shared:
+# results which may depend on the ports installed so far, and cache variables preset by the port
+# through its options or the environment, stay private to the port.
+# A check which yields a different result than the one already shared is removed from the cache for good.
+function(_vcpkg_autoconf_cache_merge shared_file local_file preset_options)
+    if(NOT EXISTS "${local_file}")
+        return()
+    endif()
+
+    set(_headers "assert|ctype|errno|float|inttypes|limits|locale|math|setjmp|signal|stdarg|stdbool|stddef|stdint|stdio|stdlib|string|time|wchar|wctype")
+    if(NOT VCPKG_TARGET_IS_WINDOWS)
+        string(APPEND _headers "|dlfcn|memory|strings|sys_stat|sys_types|unistd")
+    endif()
+    set(_types "char|short|int|long|long_long|long_long_int|unsigned_[a-z_]+|void_p|float|double|long_double|_Bool|size_t|ssize_t|off_t|pid_t|mode_t|ptrdiff_t|time_t|wchar_t|u?int(8|16|32|64|ptr|max)_t")
+
+    execute_process(COMMAND "${CMAKE_COMMAND}" -E environment OUTPUT_VARIABLE _environment)
+    string(REGEX MATCHALL "[A-Za-z0-9_]*_cv_[A-Za-z0-9_]*=" _presets "${preset_options}\n${_environment}")
+    list(TRANSFORM _presets REPLACE "=$" "")
+
+    # Ports configured at the same time must not drop each other's results.
+    file(LOCK "${shared_file}.lock" GUARD FUNCTION)
+    _vcpkg_autoconf_cache_read(_shared "${shared_file}")
+    _vcpkg_autoconf_cache_read(_local "${local_file}")
+
+    set(_changed OFF)
+    foreach(_name IN LISTS _local_NAMES)
+        list(FIND _presets "${_name}" _preset_index)
+        list(FIND _shared_CONFLICTS "${_name}" _conflict_index)
+        if(NOT (_name MATCHES "^ac_cv_(c_[a-z_]+|cxx_compiler_gnu|prog_(cc|cxx)_[a-z0-9_]+|objext|exeext|build|host|header_stdc)$"
+                OR _name MATCHES "^ac_cv_header_(${_headers})_h$"
+                OR _name MATCHES "^ac_cv_(sizeof|type)_(${_types})$")
+           OR NOT _preset_index EQUAL -1 OR NOT _conflict_index EQUAL -1)
+            continue()
+        endif()
+        if(NOT DEFINED _shared_ENTRY_${_name})
+            list(APPEND _shared_NAMES "${_name}")
+            set(_shared_ENTRY_${_name} "${_local_ENTRY_${_name}}")
+            set(_changed ON)
+        elseif(NOT _shared_ENTRY_${_name} STREQUAL _local_ENTRY_${_name})
+            message(STATUS "Removing ${_name} from the shared autoconf cache because its result differs between ports")
+            list(REMOVE_ITEM _shared_NAMES "${_name}")
+            list(APPEND _shared_CONFLICTS "${_name}")
+            set(_changed ON)
+        endif()
+    endforeach()
+    if(NOT _changed)
+        return()
+    endif()
+
+    set(_contents "# Shared autoconf cache written by vcpkg_configure_make\n")
+    foreach(_name IN LISTS _shared_CONFLICTS)
+        string(APPEND _contents "# vcpkg-conflict: ${_name}\n")
+    endforeach()
+    list(SORT _shared_NAMES)
+    foreach(_name IN LISTS _shared_NAMES)
+        string(APPEND _contents "${_shared_ENTRY_${_name}}\n")
+    endforeach()
+    # Replace the file atomically, so that an interrupted write never leaves a partial cache.
+    string(RANDOM LENGTH 8 _suffix)
+    file(WRITE "${shared_file}.${_suffix}.tmp" "${_contents}")
+    file(RENAME "${shared_file}.${_suffix}.tmp" "${shared_file}")
+endfunction()
+
 function(vcpkg_configure_make)
     # parse parameters such that semicolons in options arguments to COMMAND don't get erased
     cmake_parse_arguments(PARSE_ARGV 0 _csc
@@ -443,6 +598,15 @@ function(vcpkg_configure_make)
             # Currently needed for arm because objdump yields: "unrecognised machine type (0x1c4) in Import Library Format archive"
             list(APPEND _csc_OPTIONS lt_cv_deplibs_check_method=pass_all)
         endif()
+    elseif(VCPKG_LTO)
+        # Archives of LTO objects need the archiver of the compiler (gcc-ar, llvm-ar), which the toolchain selects;
+        # configure would pick the ar of the system.
+        if(VCPKG_DETECTED_CMAKE_AR)
+            list(APPEND _csc_OPTIONS "AR=${VCPKG_DETECTED_CMAKE_AR}")
+        endif()
+        if(VCPKG_DETECTED_CMAKE_RANLIB)
+            list(APPEND _csc_OPTIONS "RANLIB=${VCPKG_DETECTED_CMAKE_RANLIB}")
+        endif()
     endif()
 
     if(CMAKE_HOST_WIN32)
@@ -687,6 +851,9 @@ function(vcpkg_configure_make)
             endif()
             string(STRIP "${_link_dirs}" _link_dirs)
             set(LDFLAGS_${_VAR_SUFFIX} "${_link_dirs} ${LINKER_FLAGS_${_VAR_SUFFIX}}")
+            if(VCPKG_LINKER AND VCPKG_TARGET_IS_LINUX)
+                string(APPEND LDFLAGS_${_VAR_SUFFIX} " -fuse-ld=${VCPKG_LINKER}")
+            endif()
         endif()
         unset(_VAR_SUFFIX)
     endif()
@@ -720,6 +887,9 @@ function(vcpkg_configure_make)
             endif()
             string(STRIP "${_link_dirs}" _link_dirs)
             set(LDFLAGS_${_VAR_SUFFIX} "${_link_dirs} ${LINKER_FLAGS_${_VAR_SUFFIX}}")
+            if(VCPKG_LINKER AND VCPKG_TARGET_IS_LINUX)
+                string(APPEND LDFLAGS_${_VAR_SUFFIX} " -fuse-ld=${VCPKG_LINKER}")
+            endif()
         endif()
         unset(_VAR_SUFFIX)
     endif()
@@ -780,10 +950,35 @@ function(vcpkg_configure_make)
         unset(_link_path)
         unset(_lib_env_vars)
 
+        # Set up by z_vcpkg_compiler_cache_begin when the triplet sets VCPKG_COMPILER_CACHE
+        set(_cache_options)
+        if(DEFINED Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_buildtype})
+            set(_cache_options
+                "CC=${Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_buildtype}} ${VCPKG_DETECTED_CMAKE_C_COMPILER}"
+                "CXX=${Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_buildtype}} ${VCPKG_DETECTED_CMAKE_CXX_COMPILER}"
+            )
+        endif()
+        # Set up by scripts/toolchains/linux.cmake when the triplet sets VCPKG_LINKER
+        if(VCPKG_LINKER AND VCPKG_TARGET_IS_LINUX)
+            list(APPEND _cache_options "LD=${VCPKG_DETECTED_CMAKE_LINKER}")
+        endif()
+
+        # Set up the shared autoconf cache when the triplet sets VCPKG_AUTOCONF_CACHE
+        _vcpkg_autoconf_cache_get_file(_autoconf_cache_file "${TAR_DIR}/${RELATIVE_BUILD_PATH}/configure"
+            "${_csc_BUILD_TRIPLET}|${CONFIGURE_ENV}")
+        if(_autoconf_cache_file)
+            _vcpkg_autoconf_cache_seed("${_autoconf_cache_file}" "${TAR_DIR}")
+            list(APPEND _cache_options "--cache-file=config.cache")
+        endif()
+
         if(VCPKG_TARGET_IS_WINDOWS)
-            set(command "${base_cmd}" -c "${CONFIGURE_ENV} ./${RELATIVE_BUILD_PATH}/configure ${_csc_BUILD_TRIPLET} ${_csc_OPTIONS} ${_csc_OPTIONS_${_buildtype}}")
+            set(_cache_options_string)
+            foreach(_cache_option IN LISTS _cache_options)
+                string(APPEND _cache_options_string " '${_cache_option}'")
+            endforeach()
+            set(command "${base_cmd}" -c "${CONFIGURE_ENV} ./${RELATIVE_BUILD_PATH}/configure ${_csc_BUILD_TRIPLET} ${_csc_OPTIONS} ${_csc_OPTIONS_${_buildtype}}${_cache_options_string}")
         else()
-            set(command "${base_cmd}" "./${RELATIVE_BUILD_PATH}/configure" ${_csc_BUILD_TRIPLET} ${_csc_OPTIONS} ${_csc_OPTIONS_${_buildtype}})
+            set(command "${base_cmd}" "./${RELATIVE_BUILD_PATH}/configure" ${_csc_BUILD_TRIPLET} ${_csc_OPTIONS} ${_csc_OPTIONS_${_buildtype}} ${_cache_options})
         endif()
         
         if(_csc_ADD_BIN_TO_PATH)
@@ -798,6 +993,10 @@ function(vcpkg_configure_make)
                 WORKING_DIRECTORY "${TAR_DIR}"
                 LOGNAME config-${TARGET_TRIPLET}-${SHORT_NAME_${_buildtype}}
             )
+            if(_autoconf_cache_file)
+                _vcpkg_autoconf_cache_merge("${_autoconf_cache_file}" "${TAR_DIR}/config.cache"
+                    "${_csc_OPTIONS} ${_csc_OPTIONS_${_buildtype}} ${CONFIGURE_ENV}")
+            endif()
             if(VCPKG_TARGET_IS_WINDOWS AND NOT VCPKG_TARGET_IS_MINGW AND VCPKG_LIBRARY_LINKAGE STREQUAL dynamic)
                 file(GLOB_RECURSE LIBTOOL_FILES "${TAR_DIR}*/libtool")
                 foreach(lt_file IN LISTS LIBTOOL_FILES)
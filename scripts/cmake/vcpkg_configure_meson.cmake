@@ -61,6 +61,10 @@ function(vcpkg_internal_meson_generate_native_file _additional_binaries) #https:
     if(VCPKG_DETECTED_CMAKE_LINKER AND VCPKG_TARGET_IS_WINDOWS)
         string(APPEND NATIVE "c_ld = '${VCPKG_DETECTED_CMAKE_LINKER}'\n")
         string(APPEND NATIVE "cpp_ld = '${VCPKG_DETECTED_CMAKE_LINKER}'\n")
+    elseif(VCPKG_LINKER MATCHES "^(bfd|gold|lld)$" AND VCPKG_TARGET_IS_LINUX)
+        # mold is only selected by the -fuse-ld flag in the linker flags; this version of meson does not know it.
+        string(APPEND NATIVE "c_ld = '${VCPKG_LINKER}'\n")
+        string(APPEND NATIVE "cpp_ld = '${VCPKG_LINKER}'\n")
     endif()
     string(APPEND NATIVE "cmake = '${CMAKE_COMMAND}'\n")
     foreach(_binary IN LISTS ${_additional_binaries})
@@ -141,8 +145,39 @@ function(vcpkg_internal_meson_generate_flags_properties_string _out_var _config)
     set(${_out_var} "${${_out_var}}" PARENT_SCOPE)
 endfunction()
 
+# Wraps the compilers in the launcher set up by z_vcpkg_compiler_cache_begin, if any.
+# This overrides the compilers given in the configuration independent native or cross file.
+function(vcpkg_internal_meson_generate_compiler_cache_binaries _out_var _config)
+    set(BINARIES "")
+    if(DEFINED Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_config})
+        string(APPEND BINARIES "[binaries]\n")
+        foreach(prog IN ITEMS C CXX)
+            if(VCPKG_DETECTED_CMAKE_${prog}_COMPILER)
+                string(REPLACE "CXX" "CPP" mesonprog "${prog}")
+                string(TOLOWER "${mesonprog}" proglower)
+                string(APPEND BINARIES "${proglower} = ['${Z_VCPKG_COMPILER_CACHE_LAUNCHER_${_config}}', '${VCPKG_DETECTED_CMAKE_${prog}_COMPILER}']\n")
+            endif()
+        endforeach()
+    endif()
+    set(${_out_var} "${BINARIES}" PARENT_SCOPE)
+endfunction()
+
+# Enables link-time optimization of the release build when the triplet sets VCPKG_LTO,
+# like scripts/toolchains/linux.cmake does for CMake builds.
+function(vcpkg_internal_meson_generate_lto_options _out_var _config)
+    set(OPTIONS "")
+    if(VCPKG_LTO AND VCPKG_TARGET_IS_LINUX AND _config STREQUAL "RELEASE")
+        string(APPEND OPTIONS "b_lto = true\n")
+        if(VCPKG_LTO STREQUAL "thin")
+            string(APPEND OPTIONS "b_lto_mode = 'thin'\n")
+        endif()
+    endif()
+    set(${_out_var} "${OPTIONS}" PARENT_SCOPE)
+endfunction()
+
 function(vcpkg_internal_meson_generate_native_file_config _config) #https://mesonbuild.com/Native-environments.html
-    set(NATIVE_${_config} "[properties]\n") #https://mesonbuild.com/Builtin-options.html
+    vcpkg_internal_meson_generate_compiler_cache_binaries(NATIVE_${_config} ${_config})
+    string(APPEND NATIVE_${_config} "[properties]\n") #https://mesonbuild.com/Builtin-options.html
     vcpkg_internal_meson_generate_flags_properties_string(NATIVE_PROPERTIES ${_config})
     string(APPEND NATIVE_${_config} "${NATIVE_PROPERTIES}")
     #Setup CMake properties
@@ -174,6 +209,8 @@ function(vcpkg_internal_meson_generate_native_file_config _config) #https://meso
     string(APPEND NATIVE_${_config} "VCPKG_CRT_LINKAGE = '${VCPKG_CRT_LINKAGE}'\n")
 
     string(APPEND NATIVE_${_config} "[built-in options]\n")
+    vcpkg_internal_meson_generate_lto_options(NATIVE_LTO_OPTIONS ${_config})
+    string(APPEND NATIVE_${_config} "${NATIVE_LTO_OPTIONS}")
     if(VCPKG_TARGET_IS_WINDOWS)
         if(VCPKG_CRT_LINKAGE STREQUAL "static")
             set(CRT mt)
@@ -281,6 +318,10 @@ function(vcpkg_internal_meson_generate_cross_file _additional_binaries) #https:/
     if(VCPKG_DETECTED_CMAKE_LINKER AND VCPKG_TARGET_IS_WINDOWS)
         string(APPEND CROSS "c_ld = '${VCPKG_DETECTED_CMAKE_LINKER}'\n")
         string(APPEND CROSS "cpp_ld = '${VCPKG_DETECTED_CMAKE_LINKER}'\n")
+    elseif(VCPKG_LINKER MATCHES "^(bfd|gold|lld)$" AND VCPKG_TARGET_IS_LINUX)
+        # mold is only selected by the -fuse-ld flag in the linker flags; this version of meson does not know it.
+        string(APPEND CROSS "c_ld = '${VCPKG_LINKER}'\n")
+        string(APPEND CROSS "cpp_ld = '${VCPKG_LINKER}'\n")
     endif()
     foreach(_binary IN LISTS ${_additional_binaries})
         string(APPEND CROSS "${_binary}\n")
@@ -324,10 +365,13 @@ function(vcpkg_internal_meson_generate_cross_file _additional_binaries) #https:/
 endfunction()
 
 function(vcpkg_internal_meson_generate_cross_file_config _config) #https://mesonbuild.com/Native-environments.html
-    set(CROSS_${_config} "[properties]\n") #https://mesonbuild.com/Builtin-options.html
+    vcpkg_internal_meson_generate_compiler_cache_binaries(CROSS_${_config} ${_config})
+    string(APPEND CROSS_${_config} "[properties]\n") #https://mesonbuild.com/Builtin-options.html
     vcpkg_internal_meson_generate_flags_properties_string(CROSS_PROPERTIES ${_config})
     string(APPEND CROSS_${_config} "${CROSS_PROPERTIES}")
     string(APPEND CROSS_${_config} "[built-in options]\n")
+    vcpkg_internal_meson_generate_lto_options(CROSS_LTO_OPTIONS ${_config})
+    string(APPEND CROSS_${_config} "${CROSS_LTO_OPTIONS}")
     if(VCPKG_TARGET_IS_WINDOWS)
         if(VCPKG_CRT_LINKAGE STREQUAL "static")
             set(CRT mt)
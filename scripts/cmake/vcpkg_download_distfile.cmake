@@ -45,6 +45,19 @@ Headers should be specified as "<header-name>: <header-value>".
 ## Notes
 The helper [`vcpkg_from_github`](vcpkg_from_github.md) should be used for downloading from GitHub projects.
 
+Before any network access, the file is looked up by its SHA512 in the local directories listed in
+[`VCPKG_DOWNLOAD_MIRRORS`](../users/triplets.md#VCPKG_DOWNLOAD_MIRRORS);
+mirrors given as URLs are tried before the URLS passed to this function.
+
+Files are downloaded with `file(DOWNLOAD)` unless another download tool is requested.
+aria2 is used when vcpkg is asked to use it, or when the triplet sets
+[`VCPKG_DOWNLOAD_SEGMENTS`](../users/triplets.md#VCPKG_DOWNLOAD_SEGMENTS) to download large files in parallel segments.
+`curl` is used when the triplet sets [`VCPKG_DOWNLOAD_RESUME`](../users/triplets.md#VCPKG_DOWNLOAD_RESUME).
+With either of them, partially downloaded files are kept in `${DOWNLOADS}/partial` and resumed by the next attempt.
+
+Each file is hashed once, when it is downloaded. The hash is recorded together with the size and
+modification time of the file, so that later uses of the unchanged file do not read it again.
+
 ## Examples
 
 * [apr](https://github.com/Microsoft/vcpkg/blob/master/ports/apr/portfile.cmake)
@@ -53,6 +66,99 @@ The helper [`vcpkg_from_github`](vcpkg_from_github.md) should be used for downlo
 #]===]
 
 include(vcpkg_execute_in_download_mode)
+include(z_vcpkg_get_file_sha512)
+include(z_vcpkg_trace)
+
+function(z_vcpkg_download_distfile_get_setting out_var name)
+    if(NOT DEFINED "${name}" AND DEFINED "ENV{${name}}")
+        set("${name}" "$ENV{${name}}")
+    endif()
+    set("${out_var}" "${${name}}" PARENT_SCOPE)
+endfunction()
+
+# Looks up the file in the local mirror directories, which store files under their SHA512.
+function(z_vcpkg_download_distfile_from_mirrors out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "" "SHA512;DESTINATION;PART" "MIRRORS")
+    set("${out_var}" OFF PARENT_SCOPE)
+    foreach(mirror IN LISTS arg_MIRRORS)
+        if(mirror MATCHES "^[a-zA-Z][a-zA-Z0-9+.-]+://")
+            continue()
+        endif()
+        file(TO_CMAKE_PATH "${mirror}" mirror)
+        set(mirror_file "${mirror}/${arg_SHA512}")
+        if(NOT EXISTS "${mirror_file}")
+            continue()
+        endif()
+
+        message(STATUS "Copying ${mirror_file} -> ${arg_DESTINATION}")
+        get_filename_component(part_dir "${arg_PART}" DIRECTORY)
+        file(MAKE_DIRECTORY "${part_dir}")
+        execute_process(
+            COMMAND "${CMAKE_COMMAND}" -E copy "${mirror_file}" "${arg_PART}"
+            RESULT_VARIABLE error_code
+        )
+        if(NOT error_code)
+            file(SHA512 "${arg_PART}" file_hash)
+        endif()
+        if(error_code OR NOT file_hash STREQUAL arg_SHA512)
+            message(WARNING "Ignoring ${mirror_file}, which could not be copied or does not have the expected hash.")
+            file(REMOVE "${arg_PART}")
+            continue()
+        endif()
+
+        get_filename_component(destination_dir "${arg_DESTINATION}" DIRECTORY)
+        file(MAKE_DIRECTORY "${destination_dir}")
+        file(RENAME "${arg_PART}" "${arg_DESTINATION}")
+        z_vcpkg_set_file_sha512("${arg_DESTINATION}" "${file_hash}")
+        set("${out_var}" ON PARENT_SCOPE)
+        return()
+    endforeach()
+endfunction()
+
+# Downloads a single URL with curl, resuming the partial download left by an earlier attempt.
+function(z_vcpkg_download_distfile_with_curl out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "" "CURL;URL;PART" "HEADERS")
+    set(request_headers "")
+    foreach(header IN LISTS arg_HEADERS)
+        list(APPEND request_headers --header "${header}")
+    endforeach()
+    get_filename_component(part_dir "${arg_PART}" DIRECTORY)
+    file(MAKE_DIRECTORY "${part_dir}")
+
+    set(resume "")
+    if(EXISTS "${arg_PART}")
+        file(SIZE "${arg_PART}" part_size)
+        if(part_size GREATER "0")
+            message(STATUS "Resuming download after ${part_size} bytes")
+            set(resume --continue-at -)
+        endif()
+    endif()
+
+    vcpkg_execute_in_download_mode(
+        COMMAND "${arg_CURL}" --fail --location --silent --show-error --retry 3
+            ${resume} ${request_headers} --output "${arg_PART}" "${arg_URL}"
+        ERROR_VARIABLE error
+        RESULT_VARIABLE error_code
+    )
+    # 33: the server does not support ranges; 22: HTTP errors such as 416 (range not satisfiable).
+    if(NOT resume STREQUAL "" AND (error_code EQUAL "33" OR error_code EQUAL "22"))
+        message(STATUS "Unable to resume the download, starting over")
+        file(REMOVE "${arg_PART}")
+        vcpkg_execute_in_download_mode(
+            COMMAND "${arg_CURL}" --fail --location --silent --show-error --retry 3
+                ${request_headers} --output "${arg_PART}" "${arg_URL}"
+            ERROR_VARIABLE error
+            RESULT_VARIABLE error_code
+        )
+    endif()
+    if(NOT error_code STREQUAL "0")
+        string(STRIP "${error}" error)
+        message(STATUS "Downloading ${arg_URL}... Failed. Exit code: ${error_code}: ${error}")
+        set("${out_var}" 0 PARENT_SCOPE)
+    else()
+        set("${out_var}" 1 PARENT_SCOPE)
+    endif()
+endfunction()
 
 function(vcpkg_download_distfile VAR)
     set(options SKIP_SHA512 SILENT_EXIT QUIET)
@@ -76,8 +182,21 @@ function(vcpkg_download_distfile VAR)
         endif()
     endif()
 
+    z_vcpkg_trace_begin("download ${vcpkg_download_distfile_FILENAME}" CATEGORY download)
     set(downloaded_file_path ${DOWNLOADS}/${vcpkg_download_distfile_FILENAME})
-    set(download_file_path_part "${DOWNLOADS}/temp/${vcpkg_download_distfile_FILENAME}")
+
+    # Partial downloads are kept for resuming, so their name includes the hash of the complete file.
+    set(hash_known OFF)
+    if(NOT _VCPKG_INTERNAL_NO_HASH_CHECK AND NOT vcpkg_download_distfile_SKIP_SHA512)
+        set(hash_known ON)
+        string(TOLOWER "${vcpkg_download_distfile_SHA512}" vcpkg_download_distfile_SHA512)
+        string(SUBSTRING "${vcpkg_download_distfile_SHA512}" 0 16 hash_prefix)
+        set(part_name "partial/${vcpkg_download_distfile_FILENAME}-${hash_prefix}")
+    else()
+        set(part_name "partial/${vcpkg_download_distfile_FILENAME}")
+        file(REMOVE "${DOWNLOADS}/${part_name}.part" "${DOWNLOADS}/${part_name}.segments" "${DOWNLOADS}/${part_name}.segments.aria2")
+    endif()
+    set(download_file_path_part "${DOWNLOADS}/${part_name}.part")
 
     # Works around issue #3399
     if(IS_DIRECTORY "${DOWNLOADS}/temp")
@@ -100,8 +219,18 @@ function(vcpkg_download_distfile VAR)
             return()
         endif()
 
-        file(SHA512 ${FILE_PATH} FILE_HASH)
+        if(FILE_KIND STREQUAL "cached file")
+            # Skips hashing the file again if it is unchanged since it was last verified.
+            z_vcpkg_get_file_sha512(FILE_HASH "${FILE_PATH}")
+        else()
+            file(SHA512 ${FILE_PATH} FILE_HASH)
+            set(downloaded_file_hash "${FILE_HASH}" PARENT_SCOPE)
+        endif()
         if(NOT FILE_HASH STREQUAL vcpkg_download_distfile_SHA512)
+            if(FILE_KIND STREQUAL "downloaded file")
+                # Do not resume from a corrupted download.
+                file(REMOVE "${FILE_PATH}")
+            endif()
             message(FATAL_ERROR
                 "\nFile does not have expected hash:\n"
                 "        File path: [ ${FILE_PATH} ]\n"
@@ -117,13 +246,41 @@ function(vcpkg_download_distfile VAR)
         endif()
         test_hash("${downloaded_file_path}" "cached file" "Please delete the file and retry if this file should be downloaded again.")
     else()
+        z_vcpkg_download_distfile_get_setting(mirrors VCPKG_DOWNLOAD_MIRRORS)
+        z_vcpkg_download_distfile_get_setting(segments VCPKG_DOWNLOAD_SEGMENTS)
+        if(NOT segments MATCHES "^[0-9]+$" OR segments EQUAL "0")
+            set(segments 1)
+        endif()
+        z_vcpkg_download_distfile_get_setting(resume VCPKG_DOWNLOAD_RESUME)
+
+        set(mirror_urls "")
+        if(hash_known AND NOT mirrors STREQUAL "")
+            z_vcpkg_download_distfile_from_mirrors(found_in_mirror
+                SHA512 "${vcpkg_download_distfile_SHA512}"
+                DESTINATION "${downloaded_file_path}"
+                PART "${download_file_path_part}"
+                MIRRORS ${mirrors}
+            )
+            if(found_in_mirror)
+                set(${VAR} ${downloaded_file_path} PARENT_SCOPE)
+                z_vcpkg_trace_end("download ${vcpkg_download_distfile_FILENAME}" CATEGORY download)
+                return()
+            endif()
+            foreach(mirror IN LISTS mirrors)
+                if(mirror MATCHES "^[a-zA-Z][a-zA-Z0-9+.-]+://")
+                    string(REGEX REPLACE "/+$" "" mirror "${mirror}")
+                    list(APPEND mirror_urls "${mirror}/${vcpkg_download_distfile_SHA512}")
+                endif()
+            endforeach()
+        endif()
+
         if(_VCPKG_NO_DOWNLOADS)
             message(FATAL_ERROR "Downloads are disabled, but '${downloaded_file_path}' does not exist.")
         endif()
 
         # Tries to download the file.
         list(GET vcpkg_download_distfile_URLS 0 SAMPLE_URL)
-        if(_VCPKG_DOWNLOAD_TOOL STREQUAL "ARIA2" AND NOT SAMPLE_URL MATCHES "aria2")
+        if((_VCPKG_DOWNLOAD_TOOL STREQUAL "ARIA2" OR segments GREATER "1") AND NOT SAMPLE_URL MATCHES "aria2")
             vcpkg_find_acquire_program("ARIA2")
             message(STATUS "Downloading ${vcpkg_download_distfile_FILENAME}...")
             if(vcpkg_download_distfile_HEADERS)
@@ -131,9 +288,16 @@ function(vcpkg_download_distfile VAR)
                     list(APPEND request_headers "--header=${header}")
                 endforeach()
             endif()
+            # aria2 keeps a control file next to the partial download, so that all segments can be resumed.
+            set(download_file_path_part "${DOWNLOADS}/${part_name}.segments")
             vcpkg_execute_in_download_mode(
-                COMMAND ${ARIA2} ${vcpkg_download_distfile_URLS}
-                -o temp/${vcpkg_download_distfile_FILENAME}
+                COMMAND ${ARIA2} ${mirror_urls} ${vcpkg_download_distfile_URLS}
+                -o ${part_name}.segments
+                --continue=true
+                --auto-file-renaming=false
+                --split=${segments}
+                --max-connection-per-server=${segments}
+                --min-split-size=1M
                 -l download-${vcpkg_download_distfile_FILENAME}-detailed.log
                 ${request_headers}
                 OUTPUT_FILE download-${vcpkg_download_distfile_FILENAME}-out.log
@@ -160,8 +324,30 @@ function(vcpkg_download_distfile VAR)
                 set(download_success 1)
             endif()
         else()
-            foreach(url IN LISTS vcpkg_download_distfile_URLS)
+            set(curl "")
+            if(resume)
+                find_program(Z_VCPKG_CURL NAMES curl)
+                if(NOT Z_VCPKG_CURL)
+                    message(FATAL_ERROR "VCPKG_DOWNLOAD_RESUME requires curl, which could not be found.")
+                endif()
+                set(curl "${Z_VCPKG_CURL}")
+            endif()
+            foreach(url IN LISTS mirror_urls vcpkg_download_distfile_URLS)
                 message(STATUS "Downloading ${url} -> ${vcpkg_download_distfile_FILENAME}...")
+                if(curl)
+                    z_vcpkg_download_distfile_with_curl(download_success
+                        CURL "${curl}"
+                        URL "${url}"
+                        PART "${download_file_path_part}"
+                        HEADERS ${vcpkg_download_distfile_HEADERS}
+                    )
+                    if(download_success)
+                        break()
+                    endif()
+                    continue()
+                endif()
+
+                set(request_headers "")
                 if(vcpkg_download_distfile_HEADERS)
                     foreach(header ${vcpkg_download_distfile_HEADERS})
                         list(APPEND request_headers HTTPHEADER ${header})
@@ -210,6 +396,9 @@ function(vcpkg_download_distfile VAR)
                 get_filename_component(downloaded_file_dir "${downloaded_file_path}" DIRECTORY)
                 file(MAKE_DIRECTORY "${downloaded_file_dir}")
                 file(RENAME ${download_file_path_part} ${downloaded_file_path})
+                if(DEFINED downloaded_file_hash)
+                    z_vcpkg_set_file_sha512("${downloaded_file_path}" "${downloaded_file_hash}")
+                endif()
             endif()
         else()
             if (NOT download_success)
@@ -221,8 +410,12 @@ function(vcpkg_download_distfile VAR)
                 get_filename_component(downloaded_file_dir "${downloaded_file_path}" DIRECTORY)
                 file(MAKE_DIRECTORY "${downloaded_file_dir}")
                 file(RENAME ${download_file_path_part} ${downloaded_file_path})
+                if(DEFINED downloaded_file_hash)
+                    z_vcpkg_set_file_sha512("${downloaded_file_path}" "${downloaded_file_hash}")
+                endif()
             endif()
         endif()
     endif()
     set(${VAR} ${downloaded_file_path} PARENT_SCOPE)
+    z_vcpkg_trace_end("download ${vcpkg_download_distfile_FILENAME}" CATEGORY download)
 endfunction()
@@ -8,6 +8,7 @@ Execute a required build process
 vcpkg_execute_build_process(
     COMMAND <cmd> [<args>...]
     [NO_PARALLEL_COMMAND <cmd> [<args>...]]
+    [JOBS <count>]
     WORKING_DIRECTORY </path/to/dir>
     LOGNAME <log_name>
 )
@@ -20,6 +21,15 @@ The command to be executed, along with its arguments.
 Optional parameter which specifies a non-parallel command to attempt if a
 failure potentially due to parallelism is detected.
 
+### JOBS
+Optional parameter which specifies the number of jobs that `COMMAND` runs.
+
+If a failure potentially due to parallelism or to running out of memory is detected,
+the command is restarted with half as many jobs, until it succeeds or runs with a single job.
+The job count is replaced in the arguments `-j<count>`, `-j <count>` and `/m:<count>` of `COMMAND`.
+If `COMMAND` has none of these arguments, or if `JOBS` is not passed,
+the build is restarted once with `NO_PARALLEL_COMMAND` (or `COMMAND`) instead.
+
 ### WORKING_DIRECTORY
 The directory to execute the command in.
 
@@ -34,15 +44,61 @@ conflict when building multiple at once.
 * [icu](https://github.com/Microsoft/vcpkg/blob/master/ports/icu/portfile.cmake)
 #]===]
 
+# Sets out_var to TRUE if the logs of the failed build show a failure which may be caused by
+# running too many jobs: too little memory, or jobs racing on the same files.
+macro(z_vcpkg_execute_build_process_is_parallel_failure out_var)
+    if(out_contents MATCHES "LINK : fatal error LNK1102:" OR out_contents MATCHES " fatal error C1060: "
+       OR err_contents MATCHES "LINK : fatal error LNK1102:" OR err_contents MATCHES " fatal error C1060: "
+       OR out_contents MATCHES "LINK : fatal error LNK1318: Unexpected PDB error; ACCESS_DENIED"
+       OR out_contents MATCHES "LINK : fatal error LNK1104:"
+       OR out_contents MATCHES "LINK : fatal error LNK1201:"
+        # The linker ran out of memory during execution.
+       OR out_contents MATCHES "ld terminated with signal 9" OR err_contents MATCHES "ld terminated with signal 9"
+       OR out_contents MATCHES "Killed signal terminated program" OR err_contents MATCHES "Killed signal terminated program"
+       OR out_contents MATCHES "virtual memory exhausted" OR err_contents MATCHES "virtual memory exhausted"
+       OR out_contents MATCHES "Cannot allocate memory" OR err_contents MATCHES "Cannot allocate memory"
+       OR out_contents MATCHES "[Oo]ut of memory" OR err_contents MATCHES "[Oo]ut of memory"
+        # The OOM killer terminated a compiler or linker, or an allocation failed.
+       OR err_contents MATCHES "Cannot create parent directory" OR err_contents MATCHES "Cannot write file"
+        # Multiple threads using the same directory at the same time cause conflicts, will try again.
+       OR err_contents MATCHES "Can't open"
+        # Multiple threads caused the wrong order of creating folders and creating files in folders
+       )
+        set(${out_var} TRUE)
+    else()
+        set(${out_var} FALSE)
+    endif()
+endmacro()
+
+# Sets out_var to the command stored in command_var with its job count replaced by jobs,
+# or to an empty string if the command has no job count which could be replaced.
+function(z_vcpkg_execute_build_process_set_jobs out_var jobs command_var)
+    # Operate on the string form of the list, so that escaped semicolons in the arguments are kept as is.
+    set(command "${${command_var}}")
+    string(REGEX REPLACE "(^|;)-j[0-9]+(;|$)" "\\1-j${jobs}\\2" command "${command}")
+    string(REGEX REPLACE "(^|;)-j;[0-9]+(;|$)" "\\1-j;${jobs}\\2" command "${command}")
+    string(REGEX REPLACE "(^|;)/m:[0-9]+(;|$)" "\\1/m:${jobs}\\2" command "${command}")
+    # Command lines which are passed to a shell as a single argument
+    string(REGEX REPLACE "( )-j ?[0-9]+( |;|$)" "\\1-j ${jobs}\\2" command "${command}")
+    if(command STREQUAL "${${command_var}}")
+        set("${out_var}" "" PARENT_SCOPE)
+    else()
+        set("${out_var}" "${command}" PARENT_SCOPE)
+    endif()
+endfunction()
+
 function(vcpkg_execute_build_process)
     # parse parameters such that semicolons in options arguments to COMMAND don't get erased
-    cmake_parse_arguments(PARSE_ARGV 0 _ebp "" "WORKING_DIRECTORY;LOGNAME" "COMMAND;NO_PARALLEL_COMMAND")
+    cmake_parse_arguments(PARSE_ARGV 0 _ebp "" "WORKING_DIRECTORY;LOGNAME;JOBS" "COMMAND;NO_PARALLEL_COMMAND")
 
+    z_vcpkg_trace_begin("${_ebp_LOGNAME}" CATEGORY build)
+    z_vcpkg_resource_usage_begin(_ebp_USAGE)
+    set(_ebp_RETRIES 0)
     set(LOG_OUT "${CURRENT_BUILDTREES_DIR}/${_ebp_LOGNAME}-out.log")
     set(LOG_ERR "${CURRENT_BUILDTREES_DIR}/${_ebp_LOGNAME}-err.log")
 
     execute_process(
-        COMMAND ${_ebp_COMMAND}
+        COMMAND ${_ebp_USAGE_WRAPPER} ${_ebp_COMMAND}
         WORKING_DIRECTORY ${_ebp_WORKING_DIRECTORY}
         OUTPUT_FILE ${LOG_OUT}
         ERROR_FILE ${LOG_ERR}
@@ -60,50 +116,59 @@ function(vcpkg_execute_build_process)
             list(APPEND LOGS ${LOG_ERR})
         endif()
 
-        if(out_contents MATCHES "LINK : fatal error LNK1102:" OR out_contents MATCHES " fatal error C1060: "
-           OR err_contents MATCHES "LINK : fatal error LNK1102:" OR err_contents MATCHES " fatal error C1060: "
-           OR out_contents MATCHES "LINK : fatal error LNK1318: Unexpected PDB error; ACCESS_DENIED"
-           OR out_contents MATCHES "LINK : fatal error LNK1104:"
-           OR out_contents MATCHES "LINK : fatal error LNK1201:"
-            # The linker ran out of memory during execution. We will try continuing once more, with parallelism disabled.
-           OR err_contents MATCHES "Cannot create parent directory" OR err_contents MATCHES "Cannot write file"
-            # Multiple threads using the same directory at the same time cause conflicts, will try again.
-           OR err_contents MATCHES "Can't open"
-            # Multiple threads caused the wrong order of creating folders and creating files in folders
-           )
-            message(STATUS "Restarting Build without parallelism because memory exceeded")
-            set(LOG_OUT "${CURRENT_BUILDTREES_DIR}/${_ebp_LOGNAME}-out-1.log")
-            set(LOG_ERR "${CURRENT_BUILDTREES_DIR}/${_ebp_LOGNAME}-err-1.log")
-
-            if(_ebp_NO_PARALLEL_COMMAND)
-                execute_process(
-                    COMMAND ${_ebp_NO_PARALLEL_COMMAND}
-                    WORKING_DIRECTORY ${_ebp_WORKING_DIRECTORY}
-                    OUTPUT_FILE ${LOG_OUT}
-                    ERROR_FILE ${LOG_ERR}
-                    RESULT_VARIABLE error_code
-                )
-            else()
+        z_vcpkg_execute_build_process_is_parallel_failure(_ebp_PARALLEL_FAILURE)
+        if(_ebp_PARALLEL_FAILURE)
+            set(ITERATION 0)
+            set(_ebp_RETRY_JOBS "${_ebp_JOBS}")
+            while(error_code)
+                math(EXPR ITERATION "${ITERATION}+1")
+                set(_ebp_RETRIES "${ITERATION}")
+                set(_ebp_RETRY_COMMAND "")
+                if(_ebp_RETRY_JOBS GREATER 1)
+                    math(EXPR _ebp_RETRY_JOBS "${_ebp_RETRY_JOBS} / 2")
+                    z_vcpkg_execute_build_process_set_jobs(_ebp_RETRY_COMMAND "${_ebp_RETRY_JOBS}" _ebp_COMMAND)
+                endif()
+                if("${_ebp_RETRY_COMMAND}" STREQUAL "")
+                    message(STATUS "Restarting Build without parallelism because memory exceeded")
+                    set(_ebp_RETRY_JOBS 1)
+                    if(_ebp_NO_PARALLEL_COMMAND)
+                        set(_ebp_RETRY_COMMAND "${_ebp_NO_PARALLEL_COMMAND}")
+                    else()
+                        set(_ebp_RETRY_COMMAND "${_ebp_COMMAND}")
+                    endif()
+                elseif(_ebp_RETRY_JOBS EQUAL 1)
+                    message(STATUS "Restarting Build without parallelism because memory exceeded")
+                else()
+                    message(STATUS "Restarting Build with ${_ebp_RETRY_JOBS} jobs because memory exceeded")
+                endif()
+                set(LOG_OUT "${CURRENT_BUILDTREES_DIR}/${_ebp_LOGNAME}-out-${ITERATION}.log")
+                set(LOG_ERR "${CURRENT_BUILDTREES_DIR}/${_ebp_LOGNAME}-err-${ITERATION}.log")
+
                 execute_process(
-                    COMMAND ${_ebp_COMMAND}
+                    COMMAND ${_ebp_USAGE_WRAPPER} ${_ebp_RETRY_COMMAND}
                     WORKING_DIRECTORY ${_ebp_WORKING_DIRECTORY}
                     OUTPUT_FILE ${LOG_OUT}
                     ERROR_FILE ${LOG_ERR}
                     RESULT_VARIABLE error_code
                 )
-            endif()
 
-            if(error_code)
-                file(READ ${LOG_OUT} out_contents)
-                file(READ ${LOG_ERR} err_contents)
+                if(error_code)
+                    file(READ ${LOG_OUT} out_contents)
+                    file(READ ${LOG_ERR} err_contents)
 
-                if(out_contents)
-                    list(APPEND LOGS ${LOG_OUT})
-                endif()
-                if(err_contents)
-                    list(APPEND LOGS ${LOG_ERR})
+                    if(out_contents)
+                        list(APPEND LOGS ${LOG_OUT})
+                    endif()
+                    if(err_contents)
+                        list(APPEND LOGS ${LOG_ERR})
+                    endif()
+
+                    z_vcpkg_execute_build_process_is_parallel_failure(_ebp_PARALLEL_FAILURE)
+                    if(_ebp_RETRY_JOBS LESS_EQUAL 1 OR NOT _ebp_PARALLEL_FAILURE)
+                        break()
+                    endif()
                 endif()
-            endif()
+            endwhile()
         elseif(out_contents MATCHES "mt : general error c101008d: " OR out_contents MATCHES "mt.exe : general error c101008d: ")
             # Antivirus workaround - occasionally files are locked and cause mt.exe to fail
             message(STATUS "mt.exe has failed. This may be the result of anti-virus. Disabling anti-virus on the buildtree folder may improve build speed")
@@ -112,7 +177,7 @@ function(vcpkg_execute_build_process)
                 MATH(EXPR ITERATION "${ITERATION}+1")
                 message(STATUS "Restarting Build ${TARGET_TRIPLET}-${SHORT_BUILDTYPE} because of mt.exe file locking issue. Iteration: ${ITERATION}")
                 execute_process(
-                    COMMAND ${_ebp_COMMAND}
+                    COMMAND ${_ebp_USAGE_WRAPPER} ${_ebp_COMMAND}
                     OUTPUT_FILE "${LOGPREFIX}-out-${ITERATION}.log"
                     ERROR_FILE "${LOGPREFIX}-err-${ITERATION}.log"
                     RESULT_VARIABLE error_code
@@ -132,7 +197,15 @@ function(vcpkg_execute_build_process)
                     break()
                 endif()
             endwhile()
-        elseif(out_contents MATCHES "fatal error: ld terminated with signal 9 [Killed]")
+        endif()
+
+        z_vcpkg_resource_usage_end(_ebp_USAGE
+            LOGNAME "${_ebp_LOGNAME}"
+            WORKING_DIRECTORY "${_ebp_WORKING_DIRECTORY}"
+            RETRIES "${_ebp_RETRIES}"
+        )
+
+        if(error_code AND (out_contents MATCHES "ld terminated with signal 9" OR err_contents MATCHES "ld terminated with signal 9"))
             message(WARNING "ld was terminated with signal 9 [killed], please ensure your system has sufficient hard disk space and memory.")
         endif()
 
@@ -149,5 +222,11 @@ function(vcpkg_execute_build_process)
                 "  See logs for more information:\n"
                 ${STRINGIFIED_LOGS})
         endif(error_code)
+    else()
+        z_vcpkg_resource_usage_end(_ebp_USAGE
+            LOGNAME "${_ebp_LOGNAME}"
+            WORKING_DIRECTORY "${_ebp_WORKING_DIRECTORY}"
+        )
     endif(error_code)
+    z_vcpkg_trace_end("${_ebp_LOGNAME}" CATEGORY build)
 endfunction(vcpkg_execute_build_process)
@@ -77,8 +77,9 @@ Halting portfile execution.
 ]])
     endif()
 
+    z_vcpkg_resource_usage_begin(vcpkg_execute_required_process_USAGE)
     vcpkg_execute_in_download_mode(
-        COMMAND ${vcpkg_execute_required_process_COMMAND}
+        COMMAND ${vcpkg_execute_required_process_USAGE_WRAPPER} ${vcpkg_execute_required_process_COMMAND}
         OUTPUT_FILE ${LOG_OUT}
         ERROR_FILE ${LOG_ERR}
         RESULT_VARIABLE error_code
@@ -86,6 +87,10 @@ Halting portfile execution.
         ${TIMEOUT_PARAM}
         ${OUTPUT_VARIABLE_PARAM}
         ${ERROR_VARIABLE_PARAM})
+    z_vcpkg_resource_usage_end(vcpkg_execute_required_process_USAGE
+        LOGNAME "${vcpkg_execute_required_process_LOGNAME}"
+        WORKING_DIRECTORY "${vcpkg_execute_required_process_WORKING_DIRECTORY}"
+    )
     if(error_code)
         set(LOGS)
         file(READ "${LOG_OUT}" out_contents)
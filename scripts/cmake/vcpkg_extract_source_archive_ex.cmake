@@ -47,6 +47,13 @@ Relative paths are based on the port directory.
 ### NO_REMOVE_ONE_LEVEL
 Specifies that the default removal of the top level folder should not occur.
 
+## Source cache
+If the triplet or the environment sets `VCPKG_SOURCE_CACHE`, the extracted and patched sources
+are also kept in a cache below `VCPKG_SOURCE_CACHE_DIR` (by default `source-cache` in the downloads directory),
+keyed by the hashes of the archive and of the patches.
+Later builds copy the sources from the cache, using reflinks where the filesystem supports them,
+instead of extracting the archive and applying the patches again.
+
 ## Examples
 
 * [bzip2](https://github.com/Microsoft/vcpkg/blob/master/ports/bzip2/portfile.cmake)
@@ -55,6 +62,8 @@ Specifies that the default removal of the top level folder should not occur.
 #]===]
 
 include(vcpkg_extract_source_archive)
+include(z_vcpkg_get_file_sha512)
+include(z_vcpkg_trace)
 
 function(vcpkg_extract_source_archive_ex)
     # parse parameters such that semicolons in options arguments to COMMAND don't get erased
@@ -81,6 +90,7 @@ function(vcpkg_extract_source_archive_ex)
     if(NOT DEFINED _vesae_REF)
         get_filename_component(_vesae_REF ${_vesae_ARCHIVE} NAME_WE)
     endif()
+    z_vcpkg_trace_begin("extract ${_vesae_REF}" CATEGORY extract)
 
     string(REPLACE "/" "-" SANITIZED_REF "${_vesae_REF}")
 
@@ -94,7 +104,8 @@ function(vcpkg_extract_source_archive_ex)
     string(SUBSTRING ${SANITIZED_REF} ${FROM_REF} ${REF_LENGTH} SHORTENED_SANITIZED_REF)
 
     # Hash the archive hash along with the patches. Take the first 10 chars of the hash
-    file(SHA512 ${_vesae_ARCHIVE} PATCHSET_HASH)
+    # The archive hash is usually already known from vcpkg_download_distfile.
+    z_vcpkg_get_file_sha512(PATCHSET_HASH "${_vesae_ARCHIVE}")
     foreach(PATCH IN LISTS _vesae_PATCHES)
         get_filename_component(ABSOLUTE_PATCH "${PATCH}" ABSOLUTE BASE_DIR "${CURRENT_PORT_DIR}")
         file(SHA512 ${ABSOLUTE_PATCH} CURRENT_HASH)
@@ -102,6 +113,9 @@ function(vcpkg_extract_source_archive_ex)
     endforeach()
 
     string(SHA512 PATCHSET_HASH ${PATCHSET_HASH})
+    string(SHA512 SOURCE_CACHE_KEY "${PATCHSET_HASH}-${_vesae_NO_REMOVE_ONE_LEVEL}")
+    string(SUBSTRING ${SOURCE_CACHE_KEY} 0 32 SOURCE_CACHE_KEY)
+    set(SOURCE_CACHE_KEY "${SHORTENED_SANITIZED_REF}-${SOURCE_CACHE_KEY}")
     string(SUBSTRING ${PATCHSET_HASH} 0 10 PATCHSET_HASH)
     set(SOURCE_PATH "${_vesae_WORKING_DIRECTORY}/${SHORTENED_SANITIZED_REF}-${PATCHSET_HASH}")
     if (NOT _VCPKG_EDITABLE)
@@ -112,6 +126,13 @@ function(vcpkg_extract_source_archive_ex)
         endif()
     endif()
 
+    if(NOT EXISTS ${SOURCE_PATH})
+        z_vcpkg_source_cache_restore(SOURCE_CACHE_RESTORED
+            KEY "${SOURCE_CACHE_KEY}"
+            DESTINATION "${SOURCE_PATH}"
+        )
+    endif()
+
     if(NOT EXISTS ${SOURCE_PATH})
         set(TEMP_DIR "${_vesae_WORKING_DIRECTORY}/${SHORTENED_SANITIZED_REF}-${PATCHSET_HASH}.tmp")
         file(REMOVE_RECURSE ${TEMP_DIR})
@@ -147,11 +168,17 @@ function(vcpkg_extract_source_archive_ex)
             PATCHES ${_vesae_PATCHES}
         )
 
+        z_vcpkg_source_cache_store(
+            KEY "${SOURCE_CACHE_KEY}"
+            SOURCE "${TEMP_SOURCE_PATH}"
+        )
+
         file(RENAME ${TEMP_SOURCE_PATH} ${SOURCE_PATH})
         file(REMOVE_RECURSE ${TEMP_DIR})
     endif()
 
     set(${_vesae_OUT_SOURCE_PATH} "${SOURCE_PATH}" PARENT_SCOPE)
     message(STATUS "Using source at ${SOURCE_PATH}")
+    z_vcpkg_trace_end("extract ${_vesae_REF}" CATEGORY extract)
     return()
 endfunction()
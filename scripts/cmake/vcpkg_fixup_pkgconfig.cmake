@@ -96,6 +96,7 @@ function(vcpkg_fixup_pkgconfig)
     if(_vfpkg_UNPARSED_ARGUMENTS)
         message(FATAL_ERROR "vcpkg_fixup_pkgconfig() was passed extra arguments: ${_vfct_UNPARSED_ARGUMENTS}")
     endif()
+    z_vcpkg_trace_begin("fixup_pkgconfig" CATEGORY fixup)
 
     if((DEFINED _vfpkg_RELEASE_FILES AND NOT DEFINED _vfpkg_DEBUG_FILES) OR (NOT DEFINED _vfpkg_RELEASE_FILES AND DEFINED _vfpkg_DEBUG_FILES))
         message(FATAL_ERROR "vcpkg_fixup_pkgconfig() requires both or neither of DEBUG_FILES and RELEASE_FILES")
@@ -188,4 +189,5 @@ function(vcpkg_fixup_pkgconfig)
     # Theoreotically vcpkg could look for *.pc files and automatically call this function
     # or check if this function has been called if *.pc files are detected.
     # The same is true for vcpkg_fixup_cmake_targets
+    z_vcpkg_trace_end("fixup_pkgconfig" CATEGORY fixup)
 endfunction()
@@ -10,6 +10,7 @@ vcpkg_from_git(
     URL <https://android.googlesource.com/platform/external/fdlibm>
     REF <59f7335e4d...>
     [TAG <v1.0.2>]
+    [SPARSE_PATHS <subdirectory>...]
     [PATCHES <patch1.patch> <patch2.patch>...]
 )
 ```
@@ -29,6 +30,13 @@ The git sha of the commit to download.
 ### TAG
 An optional git tag to be verified against the `REF`. If the remote repository's tag does not match the specified `REF`, the build will fail.
 
+### SPARSE_PATHS
+An optional list of paths in the repository, relative to its root, to be extracted instead of the whole tree.
+
+Only the files below these paths are downloaded, which saves time and space for large repositories
+of which the port needs only a few subdirectories. The paths keep their location relative to the root of the repository
+in the extracted sources.
+
 ### PATCHES
 A list of patches to be applied to the extracted sources.
 
@@ -40,6 +48,17 @@ This parameter is used for automatic REF updates for certain ports in the centra
 ## Notes:
 `OUT_SOURCE_PATH`, `REF`, and `URL` must be specified.
 
+Each repository is fetched into a bare repository in `${DOWNLOADS}/git-objects`, which is kept between builds,
+so that other refs of the same repository only transfer the objects which are not yet present.
+Only the commit `REF` is fetched (`--depth 1`). If `SPARSE_PATHS` is given, the repository is fetched into
+a separate partial clone, from which the contents of other paths are filtered out (`--filter=blob:none`)
+and never downloaded; the contents of `SPARSE_PATHS` are fetched in batches of 500 files before extracting them.
+The `.gitattributes` files of the repository, such as `export-ignore`, are not applied to `SPARSE_PATHS`.
+If the repository already contains `REF` and `TAG` is not given, nothing is fetched;
+if the contents of some files of `REF` are missing from a full clone, `REF` is fetched again.
+The repository is locked while it is used, so that concurrent builds can share it.
+The directory may be deleted at any time.
+
 ## Examples:
 
 * [fdlibm](https://github.com/Microsoft/vcpkg/blob/master/ports/fdlibm/portfile.cmake)
@@ -47,9 +66,34 @@ This parameter is used for automatic REF updates for certain ports in the centra
 
 include(vcpkg_execute_in_download_mode)
 
+# Creates the bare repository <store> for <url>. A partial clone fetches the contents of files only when they are used.
+function(z_vcpkg_from_git_init_store store url partial)
+  # Note: git init is safe to run multiple times
+  file(MAKE_DIRECTORY "${store}")
+  vcpkg_execute_required_process(
+    ALLOW_IN_DOWNLOAD_MODE
+    COMMAND ${GIT} init --bare .
+    WORKING_DIRECTORY ${store}
+    LOGNAME git-init-${TARGET_TRIPLET}
+  )
+  set(configs "remote.origin.url=${url}")
+  if(partial)
+    list(APPEND configs "remote.origin.promisor=true" "remote.origin.partialclonefilter=blob:none")
+  endif()
+  foreach(config IN LISTS configs)
+    string(REGEX MATCH "^([^=]*)=(.*)$" config "${config}")
+    vcpkg_execute_required_process(
+      ALLOW_IN_DOWNLOAD_MODE
+      COMMAND ${GIT} config "${CMAKE_MATCH_1}" "${CMAKE_MATCH_2}"
+      WORKING_DIRECTORY ${store}
+      LOGNAME git-config-${TARGET_TRIPLET}
+    )
+  endforeach()
+endfunction()
+
 function(vcpkg_from_git)
   set(oneValueArgs OUT_SOURCE_PATH URL REF TAG X_OUT_REF)
-  set(multipleValuesArgs PATCHES)
+  set(multipleValuesArgs PATCHES SPARSE_PATHS)
   # parse parameters such that semicolons in options arguments to COMMAND don't get erased
   cmake_parse_arguments(PARSE_ARGV 0 _vdud "" "${oneValueArgs}" "${multipleValuesArgs}")
 
@@ -71,40 +115,116 @@ function(vcpkg_from_git)
   
   # using .tar.gz instead of .zip because the hash of the latter is affected by timezone.
   string(REPLACE "/" "-" SANITIZED_REF "${_vdud_TAG}")
-  set(TEMP_ARCHIVE "${DOWNLOADS}/temp/${PORT}-${SANITIZED_REF}.tar.gz")
-  set(ARCHIVE "${DOWNLOADS}/${PORT}-${SANITIZED_REF}.tar.gz")
+  set(ARCHIVE_NAME "${PORT}-${SANITIZED_REF}")
+  if(DEFINED _vdud_SPARSE_PATHS)
+    string(SHA1 SPARSE_PATHS_HASH "${_vdud_SPARSE_PATHS}")
+    string(SUBSTRING "${SPARSE_PATHS_HASH}" 0 10 SPARSE_PATHS_HASH)
+    string(APPEND ARCHIVE_NAME "-${SPARSE_PATHS_HASH}")
+  endif()
+  set(TEMP_ARCHIVE "${DOWNLOADS}/temp/${ARCHIVE_NAME}.tar.gz")
+  set(ARCHIVE "${DOWNLOADS}/${ARCHIVE_NAME}.tar.gz")
   set(TEMP_SOURCE_PATH "${CURRENT_BUILDTREES_DIR}/src/${SANITIZED_REF}")
 
   if(NOT EXISTS "${ARCHIVE}")
     if(_VCPKG_NO_DOWNLOADS)
         message(FATAL_ERROR "Downloads are disabled, but '${ARCHIVE}' does not exist.")
     endif()
-    message(STATUS "Fetching ${_vdud_URL}...")
     find_program(GIT NAMES git git.cmd)
-    # Note: git init is safe to run multiple times
-    vcpkg_execute_required_process(
-      ALLOW_IN_DOWNLOAD_MODE
-      COMMAND ${GIT} init git-tmp
-      WORKING_DIRECTORY ${DOWNLOADS}
-      LOGNAME git-init-${TARGET_TRIPLET}
-    )
-    vcpkg_execute_required_process(
-      ALLOW_IN_DOWNLOAD_MODE
-      COMMAND ${GIT} fetch ${_vdud_URL} ${_vdud_TAG} --depth 1 -n
-      WORKING_DIRECTORY ${DOWNLOADS}/git-tmp
-      LOGNAME git-fetch-${TARGET_TRIPLET}
-    )
-    vcpkg_execute_in_download_mode(
-      COMMAND ${GIT} rev-parse FETCH_HEAD
-      OUTPUT_VARIABLE REV_PARSE_HEAD
-      ERROR_VARIABLE REV_PARSE_HEAD
-      RESULT_VARIABLE error_code
-      WORKING_DIRECTORY ${DOWNLOADS}/git-tmp
-    )
-    if(error_code)
-        message(FATAL_ERROR "unable to determine FETCH_HEAD after fetching git repository")
+
+    # One persistent object store per repository, so that later fetches only transfer new objects.
+    string(REGEX REPLACE "/+$" "" NORMALIZED_URL "${_vdud_URL}")
+    string(REGEX REPLACE "\\.git$" "" REPOSITORY_NAME "${NORMALIZED_URL}")
+    string(REGEX REPLACE "^.*[/:]" "" REPOSITORY_NAME "${REPOSITORY_NAME}")
+    string(REGEX REPLACE "[^A-Za-z0-9_.-]" "_" REPOSITORY_NAME "${REPOSITORY_NAME}")
+    string(SHA1 URL_HASH "${NORMALIZED_URL}")
+    string(SUBSTRING "${URL_HASH}" 0 16 URL_HASH)
+    set(GIT_STORE "${DOWNLOADS}/git-objects/${REPOSITORY_NAME}-${URL_HASH}")
+    set(PARTIAL OFF)
+    if(DEFINED _vdud_SPARSE_PATHS)
+      # Partial clones are kept apart, so that the full clone always has the contents of the files it fetched.
+      set(PARTIAL ON)
+      string(APPEND GIT_STORE "-partial")
+    endif()
+    string(APPEND GIT_STORE ".git")
+    # Concurrent fetches into the same repository race on its shallow file and refs.
+    file(MAKE_DIRECTORY "${DOWNLOADS}/git-objects")
+    file(LOCK "${GIT_STORE}.lock" GUARD FUNCTION)
+    z_vcpkg_from_git_init_store("${GIT_STORE}" "${_vdud_URL}" "${PARTIAL}")
+
+    # Fetch into a ref of this port rather than FETCH_HEAD, so that ports sharing the repository do not interfere.
+    set(FETCHED_REF "refs/vcpkg/${PORT}-${SANITIZED_REF}")
+    set(HAVE_REF OFF)
+    if(_vdud_TAG STREQUAL _vdud_REF AND NOT DEFINED _vdud_X_OUT_REF AND PARTIAL)
+      # Looking up a missing object in a partial clone would fetch it from the promisor remote.
+      vcpkg_execute_in_download_mode(
+        COMMAND ${GIT} rev-parse --verify --quiet "${FETCHED_REF}"
+        OUTPUT_VARIABLE fetched_rev
+        ERROR_QUIET
+        RESULT_VARIABLE error_code
+        WORKING_DIRECTORY ${GIT_STORE}
+      )
+      string(STRIP "${fetched_rev}" fetched_rev)
+      if(NOT error_code AND fetched_rev STREQUAL _vdud_REF)
+        set(HAVE_REF ON)
+      endif()
+    elseif(_vdud_TAG STREQUAL _vdud_REF AND NOT DEFINED _vdud_X_OUT_REF)
+      vcpkg_execute_in_download_mode(
+        COMMAND ${GIT} cat-file -e "${_vdud_REF}^{commit}"
+        OUTPUT_QUIET
+        ERROR_QUIET
+        RESULT_VARIABLE error_code
+        WORKING_DIRECTORY ${GIT_STORE}
+      )
+      if(NOT error_code)
+        set(HAVE_REF ON)
+      endif()
+    endif()
+
+    # A full clone which was fetched with a filter, for example by an older version of this function,
+    # may lack the contents of some files, which git archive would then fetch one at a time.
+    if(HAVE_REF AND NOT PARTIAL)
+      vcpkg_execute_in_download_mode(
+        COMMAND ${GIT} rev-list --objects --missing=print "${_vdud_REF}"
+        OUTPUT_VARIABLE REV_LIST
+        ERROR_QUIET
+        RESULT_VARIABLE error_code
+        WORKING_DIRECTORY ${GIT_STORE}
+      )
+      if(error_code OR REV_LIST MATCHES "(^|\n)\\?")
+        message(STATUS "${GIT_STORE} lacks some files of ${_vdud_REF}; fetching it again")
+        file(REMOVE_RECURSE "${GIT_STORE}")
+        z_vcpkg_from_git_init_store("${GIT_STORE}" "${_vdud_URL}" OFF)
+        set(HAVE_REF OFF)
+      endif()
+    endif()
+
+    if(HAVE_REF)
+      message(STATUS "Using ${_vdud_REF} from ${GIT_STORE}")
+      set(REV_PARSE_HEAD "${_vdud_REF}")
+    else()
+      message(STATUS "Fetching ${_vdud_URL}...")
+      set(FETCH_FILTER "")
+      if(PARTIAL)
+        set(FETCH_FILTER --filter=blob:none)
+      endif()
+      vcpkg_execute_required_process(
+        ALLOW_IN_DOWNLOAD_MODE
+        COMMAND ${GIT} fetch origin "+${_vdud_TAG}:${FETCHED_REF}" --depth 1 -n ${FETCH_FILTER}
+        WORKING_DIRECTORY ${GIT_STORE}
+        LOGNAME git-fetch-${TARGET_TRIPLET}
+      )
+      vcpkg_execute_in_download_mode(
+        COMMAND ${GIT} rev-parse "${FETCHED_REF}^{commit}"
+        OUTPUT_VARIABLE REV_PARSE_HEAD
+        ERROR_VARIABLE REV_PARSE_HEAD
+        RESULT_VARIABLE error_code
+        WORKING_DIRECTORY ${GIT_STORE}
+      )
+      if(error_code)
+          message(FATAL_ERROR "unable to determine ${FETCHED_REF} after fetching git repository")
+      endif()
+      string(REGEX REPLACE "\n$" "" REV_PARSE_HEAD "${REV_PARSE_HEAD}")
     endif()
-    string(REGEX REPLACE "\n$" "" REV_PARSE_HEAD "${REV_PARSE_HEAD}")
     if(NOT REV_PARSE_HEAD STREQUAL _vdud_REF AND NOT DEFINED _vdud_X_OUT_REF)
         message(STATUS "[Expected : ( ${_vdud_REF} )]")
         message(STATUS "[  Actual : ( ${REV_PARSE_HEAD} )]")
@@ -114,11 +234,42 @@ function(vcpkg_from_git)
         return()
     endif()
 
+    set(ARCHIVE_PATHS "")
+    if(DEFINED _vdud_SPARSE_PATHS)
+      # Reading the attributes from the tree of REF would fetch the contents of all its files.
+      set(ARCHIVE_PATHS --worktree-attributes -- ${_vdud_SPARSE_PATHS})
+      # git archive would fetch each missing file of these paths on its own; fetch them in a few batches instead.
+      vcpkg_execute_in_download_mode(
+        COMMAND ${GIT} rev-list --objects --missing=print "${REV_PARSE_HEAD}" -- ${_vdud_SPARSE_PATHS}
+        OUTPUT_VARIABLE REV_LIST
+        ERROR_VARIABLE REV_LIST
+        RESULT_VARIABLE error_code
+        WORKING_DIRECTORY ${GIT_STORE}
+      )
+      if(error_code)
+        message(FATAL_ERROR "unable to list the files of ${REV_PARSE_HEAD} in ${GIT_STORE}:\n${REV_LIST}")
+      endif()
+      string(REGEX MATCHALL "(^|\n)\\?[0-9a-f]+" MISSING_OBJECTS "${REV_LIST}")
+      list(TRANSFORM MISSING_OBJECTS REPLACE "^\n?\\?" "")
+      # Batches keep the command line below the limit of Windows.
+      list(LENGTH MISSING_OBJECTS missing_count)
+      set(batch_begin 0)
+      while(batch_begin LESS missing_count)
+        list(SUBLIST MISSING_OBJECTS ${batch_begin} 500 batch)
+        vcpkg_execute_required_process(
+          ALLOW_IN_DOWNLOAD_MODE
+          COMMAND ${GIT} -c fetch.negotiationAlgorithm=noop fetch origin --no-tags --filter=blob:none ${batch}
+          WORKING_DIRECTORY ${GIT_STORE}
+          LOGNAME git-fetch-sparse-${TARGET_TRIPLET}
+        )
+        math(EXPR batch_begin "${batch_begin} + 500")
+      endwhile()
+    endif()
     file(MAKE_DIRECTORY "${DOWNLOADS}/temp")
     vcpkg_execute_required_process(
       ALLOW_IN_DOWNLOAD_MODE
-      COMMAND ${GIT} archive FETCH_HEAD -o "${TEMP_ARCHIVE}"
-      WORKING_DIRECTORY ${DOWNLOADS}/git-tmp
+      COMMAND ${GIT} archive "${REV_PARSE_HEAD}" -o "${TEMP_ARCHIVE}" ${ARCHIVE_PATHS}
+      WORKING_DIRECTORY ${GIT_STORE}
       LOGNAME git-archive
     )
 
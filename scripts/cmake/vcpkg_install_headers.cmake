@@ -0,0 +1,101 @@
+#[===[.md:
+# vcpkg_install_headers
+
+Install a tree of header files into the package, without copying their contents where the filesystem allows it.
+
+```cmake
+vcpkg_install_headers(
+    SOURCE <${SOURCE_PATH}/include>
+    [DESTINATION <${CURRENT_PACKAGES_DIR}/include>]
+)
+```
+
+## Parameters
+### SOURCE
+The directory whose contents are installed.
+
+### DESTINATION
+The directory the contents of `SOURCE` are installed to. Defaults to `${CURRENT_PACKAGES_DIR}/include`.
+Files which already exist in `DESTINATION` are replaced.
+
+## Notes
+How the files are installed is selected by `VCPKG_INSTALL_HEADERS_MODE`, which is read from the triplet,
+or from the environment variable of the same name if the triplet does not set it:
+* `reflink` (the default) creates reflinks on filesystems which support them (such as Btrfs, XFS and APFS),
+  which share the data of the files until either copy is modified, and plain copies otherwise.
+* `hardlink` creates hard links to the files in `SOURCE`, falling back to plain copies
+  when that is not possible, for example because `SOURCE` is on another filesystem.
+  Since a hard link is the same file as its source, modifying an installed header in place,
+  for example with `vcpkg_replace_string()`, also modifies the header in `SOURCE`.
+  This is harmless for the sources in the buildtree, which are extracted again by every build;
+  when building with `--editable`, which keeps these sources, plain copies are made instead.
+* `copy` makes plain copies, like `file(COPY)`.
+
+All modes result in the same package contents, so the mode is not part of the ABI hash.
+
+## Examples
+
+* [boost-vcpkg-helpers](https://github.com/Microsoft/vcpkg/blob/master/ports/boost-vcpkg-helpers/boost-modular-headers.cmake)
+* [ctre](https://github.com/Microsoft/vcpkg/blob/master/ports/ctre/portfile.cmake)
+#]===]
+
+function(vcpkg_install_headers)
+    cmake_parse_arguments(PARSE_ARGV 0 "arg" "" "SOURCE;DESTINATION" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "vcpkg_install_headers was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT DEFINED arg_SOURCE)
+        message(FATAL_ERROR "SOURCE must be specified.")
+    endif()
+    if(NOT IS_DIRECTORY "${arg_SOURCE}")
+        message(FATAL_ERROR "SOURCE (${arg_SOURCE}) is not a directory.")
+    endif()
+    if(NOT DEFINED arg_DESTINATION)
+        set(arg_DESTINATION "${CURRENT_PACKAGES_DIR}/include")
+    endif()
+
+    set(mode "${VCPKG_INSTALL_HEADERS_MODE}")
+    if(mode STREQUAL "" AND DEFINED ENV{VCPKG_INSTALL_HEADERS_MODE})
+        set(mode "$ENV{VCPKG_INSTALL_HEADERS_MODE}")
+    endif()
+    if(mode STREQUAL "")
+        set(mode reflink)
+    elseif(NOT mode MATCHES "^(copy|reflink|hardlink)$")
+        message(FATAL_ERROR "VCPKG_INSTALL_HEADERS_MODE must be copy, reflink or hardlink; got '${mode}'.")
+    endif()
+    if(mode STREQUAL "hardlink" AND _VCPKG_EDITABLE)
+        set(mode copy)
+    endif()
+
+    file(MAKE_DIRECTORY "${arg_DESTINATION}")
+    if(mode STREQUAL "hardlink")
+        file(GLOB_RECURSE files LIST_DIRECTORIES true RELATIVE "${arg_SOURCE}" "${arg_SOURCE}/*")
+        foreach(file IN LISTS files)
+            if(IS_DIRECTORY "${arg_SOURCE}/${file}" AND NOT IS_SYMLINK "${arg_SOURCE}/${file}")
+                file(MAKE_DIRECTORY "${arg_DESTINATION}/${file}")
+            else()
+                file(REMOVE "${arg_DESTINATION}/${file}")
+                file(CREATE_LINK "${arg_SOURCE}/${file}" "${arg_DESTINATION}/${file}" COPY_ON_ERROR)
+            endif()
+        endforeach()
+        return()
+    endif()
+
+    if(mode STREQUAL "reflink" AND CMAKE_HOST_UNIX)
+        if(CMAKE_HOST_APPLE)
+            set(cp_options -c -R -p)
+        else()
+            set(cp_options -R -p --reflink=auto)
+        endif()
+        execute_process(
+            COMMAND cp ${cp_options} "${arg_SOURCE}/." "${arg_DESTINATION}"
+            RESULT_VARIABLE error_code
+            OUTPUT_QUIET
+            ERROR_QUIET
+        )
+        if(error_code EQUAL "0")
+            return()
+        endif()
+    endif()
+    file(COPY "${arg_SOURCE}/" DESTINATION "${arg_DESTINATION}")
+endfunction()
@@ -12,6 +12,9 @@ vcpkg_install_meson([ADD_BIN_TO_PATH])
 ### ADD_BIN_TO_PATH
 Adds the appropriate Release and Debug `bin\` directories to the path during the build such that executables can run against the in-tree DLLs.
 
+## Notes:
+If the triplet sets `VCPKG_CONCURRENT_BUILD_TYPES`, the debug and release builds run at the same time.
+
 ## Examples
 
 * [fribidi](https://github.com/Microsoft/vcpkg/blob/master/ports/fribidi/portfile.cmake)
@@ -35,6 +38,9 @@ function(vcpkg_install_meson)
         set(ENV{MACOSX_DEPLOYMENT_TARGET} "${VCPKG_DETECTED_CMAKE_OSX_DEPLOYMENT_TARGET}")
     endif()
 
+    z_vcpkg_concurrent_build_begin(JOBS)
+    get_property(concurrent GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_ACTIVE)
+
     foreach(BUILDTYPE "debug" "release")
         if(DEFINED VCPKG_BUILD_TYPE AND NOT VCPKG_BUILD_TYPE STREQUAL BUILDTYPE)
             continue()
@@ -55,16 +61,29 @@ function(vcpkg_install_meson)
                 vcpkg_add_to_path(PREPEND "${CURRENT_INSTALLED_DIR}/bin")
             endif()
         endif()
-        vcpkg_execute_required_process(
-            COMMAND ${NINJA} install -v
-            WORKING_DIRECTORY ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
-            LOGNAME package-${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
-        )
+        if(concurrent)
+            # Each build type gets its share of the jobs, so that both builds together do not overload the machine.
+            z_vcpkg_concurrent_build_add(
+                BUILD_TYPE ${BUILDTYPE}
+                COMMAND ${NINJA} install -v -j${JOBS}
+                JOBS ${JOBS}
+                WORKING_DIRECTORY ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
+                LOGNAME package-${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
+            )
+        else()
+            vcpkg_execute_required_process(
+                COMMAND ${NINJA} install -v
+                WORKING_DIRECTORY ${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
+                LOGNAME package-${TARGET_TRIPLET}-${SHORT_BUILDTYPE}
+            )
+        endif()
         if(_im_ADD_BIN_TO_PATH)
             set(ENV{PATH} "${_BACKUP_ENV_PATH}")
         endif()
     endforeach()
 
+    z_vcpkg_concurrent_build_end()
+
     set(RENAMED_LIBS)
     if(VCPKG_TARGET_IS_WINDOWS AND VCPKG_LIBRARY_LINKAGE STREQUAL static)
         # Meson names all static libraries lib<name>.a which basically breaks the world
@@ -22,11 +22,35 @@ Variable to return the path to the generated cmake file with the detected `CMAKE
 ## Notes
 If possible avoid usage in portfiles. 
 
+The detected variables are cached below `${DOWNLOADS}/cmake-vars-cache`, keyed by the triplet,
+the values of all `VCPKG_` variables, `OPTIONS`, the toolchain files and the relevant environment variables.
+Later calls with the same key reuse them instead of configuring the dummy project again,
+unless the size or modification time of a detected compiler or tool has changed since.
+Delete that directory to force the detection to run again.
+
 ## Examples
 
 * [vcpkg_configure_make](https://github.com/Microsoft/vcpkg/blob/master/scripts/cmake/vcpkg_configure_make.cmake)
 #]===]
 
+# Computes a fingerprint of the compilers and tools detected in the given cmake-vars files,
+# from the size and modification time of each of them.
+function(z_vcpkg_internal_get_cmake_vars_fingerprint out_var)
+    foreach(_gcv_VARS_FILE IN LISTS ARGN)
+        include("${_gcv_VARS_FILE}")
+    endforeach()
+    set(_gcv_FINGERPRINT "")
+    foreach(_gcv_PROG IN ITEMS C_COMPILER CXX_COMPILER RC_COMPILER AR RANLIB STRIP NM OBJDUMP DLLTOOL MT LINKER)
+        set(_gcv_PATH "${VCPKG_DETECTED_CMAKE_${_gcv_PROG}}")
+        if(IS_ABSOLUTE "${_gcv_PATH}" AND EXISTS "${_gcv_PATH}" AND NOT IS_DIRECTORY "${_gcv_PATH}")
+            file(SIZE "${_gcv_PATH}" _gcv_SIZE)
+            file(TIMESTAMP "${_gcv_PATH}" _gcv_TIME "%Y-%m-%dT%H:%M:%S" UTC)
+            string(APPEND _gcv_FINGERPRINT "${_gcv_PATH}|${_gcv_SIZE}|${_gcv_TIME}\n")
+        endif()
+    endforeach()
+    set(${out_var} "${_gcv_FINGERPRINT}" PARENT_SCOPE)
+endfunction()
+
 function(vcpkg_internal_get_cmake_vars)
     cmake_parse_arguments(PARSE_ARGV 0 _gcv "" "OUTPUT_FILE" "OPTIONS")
 
@@ -46,22 +70,89 @@ function(vcpkg_internal_get_cmake_vars)
         set(${_gcv_OUTPUT_FILE} "${DEFAULT_OUT}")
     endif()
 
-    vcpkg_configure_cmake(
-        SOURCE_PATH "${SCRIPTS}/get_cmake_vars"
-        OPTIONS ${_gcv_OPTIONS} "-DVCPKG_BUILD_TYPE=${VCPKG_BUILD_TYPE}"
-        OPTIONS_DEBUG "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log"
-        OPTIONS_RELEASE "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log"
-        PREFER_NINJA
-        LOGNAME get-cmake-vars-${TARGET_TRIPLET}
-    )
-
-    set(_include_string)
+    set(_gcv_VARS_FILES)
     if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "release")
-        string(APPEND _include_string "include(\"${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log\")\n")
+        list(APPEND _gcv_VARS_FILES "${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log")
     endif()
     if(NOT DEFINED VCPKG_BUILD_TYPE OR VCPKG_BUILD_TYPE STREQUAL "debug")
-        string(APPEND _include_string "include(\"${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log\")\n")
+        list(APPEND _gcv_VARS_FILES "${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log")
+    endif()
+
+    # The detected variables only depend on the triplet, the toolchain, the environment and the options.
+    set(_gcv_KEY "CMAKE_VERSION=${CMAKE_VERSION}\nTARGET_TRIPLET=${TARGET_TRIPLET}\nOPTIONS=${_gcv_OPTIONS}\n")
+    get_cmake_property(_gcv_VARIABLES VARIABLES)
+    list(SORT _gcv_VARIABLES)
+    foreach(_gcv_VAR IN LISTS _gcv_VARIABLES)
+        if(_gcv_VAR MATCHES "^VCPKG_" AND NOT _gcv_VAR MATCHES "^VCPKG_(DETECTED|POLICY)_")
+            string(APPEND _gcv_KEY "${_gcv_VAR}=${${_gcv_VAR}}\n")
+        endif()
+    endforeach()
+    foreach(_gcv_ENV IN ITEMS PATH INCLUDE C_INCLUDE_PATH CPLUS_INCLUDE_PATH LIB LIBPATH LIBRARY_PATH LD_LIBRARY_PATH
+                              CC CXX CFLAGS CXXFLAGS CPPFLAGS LDFLAGS SDKROOT MACOSX_DEPLOYMENT_TARGET)
+        string(APPEND _gcv_KEY "ENV{${_gcv_ENV}}=$ENV{${_gcv_ENV}}\n")
+    endforeach()
+    file(GLOB _gcv_TOOLCHAIN_FILES "${SCRIPTS}/toolchains/*.cmake")
+    foreach(_gcv_FILE IN LISTS _gcv_TOOLCHAIN_FILES ITEMS
+            "${SCRIPTS}/buildsystems/vcpkg.cmake"
+            "${SCRIPTS}/get_cmake_vars/CMakeLists.txt"
+            "${SCRIPTS}/cmake/vcpkg_configure_cmake.cmake"
+            "${VCPKG_CHAINLOAD_TOOLCHAIN_FILE}")
+        if(EXISTS "${_gcv_FILE}" AND NOT IS_DIRECTORY "${_gcv_FILE}")
+            file(SHA512 "${_gcv_FILE}" _gcv_FILE_HASH)
+            string(APPEND _gcv_KEY "${_gcv_FILE}=${_gcv_FILE_HASH}\n")
+        endif()
+    endforeach()
+    string(SHA512 _gcv_KEY "${_gcv_KEY}")
+    string(SUBSTRING "${_gcv_KEY}" 0 32 _gcv_KEY)
+    set(_gcv_CACHE_DIR "${DOWNLOADS}/cmake-vars-cache/${TARGET_TRIPLET}-${_gcv_KEY}")
+
+    set(_gcv_CACHE_HIT OFF)
+    if(EXISTS "${_gcv_CACHE_DIR}/fingerprint.txt")
+        set(_gcv_CACHED_FILES)
+        foreach(_gcv_VARS_FILE IN LISTS _gcv_VARS_FILES)
+            get_filename_component(_gcv_NAME "${_gcv_VARS_FILE}" NAME)
+            list(APPEND _gcv_CACHED_FILES "${_gcv_CACHE_DIR}/${_gcv_NAME}")
+        endforeach()
+        file(READ "${_gcv_CACHE_DIR}/fingerprint.txt" _gcv_CACHED_FINGERPRINT)
+        z_vcpkg_internal_get_cmake_vars_fingerprint(_gcv_FINGERPRINT ${_gcv_CACHED_FILES})
+        if(_gcv_FINGERPRINT STREQUAL _gcv_CACHED_FINGERPRINT)
+            set(_gcv_CACHE_HIT ON)
+        else()
+            message(STATUS "The compilers of ${TARGET_TRIPLET} have changed; detecting them again")
+        endif()
     endif()
+
+    if(_gcv_CACHE_HIT)
+        message(STATUS "Using cached compiler detection for ${TARGET_TRIPLET}")
+        file(COPY ${_gcv_CACHED_FILES} DESTINATION "${CURRENT_BUILDTREES_DIR}")
+    else()
+        vcpkg_configure_cmake(
+            SOURCE_PATH "${SCRIPTS}/get_cmake_vars"
+            OPTIONS ${_gcv_OPTIONS} "-DVCPKG_BUILD_TYPE=${VCPKG_BUILD_TYPE}"
+            OPTIONS_DEBUG "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-dbg.cmake.log"
+            OPTIONS_RELEASE "-DVCPKG_OUTPUT_FILE:PATH=${CURRENT_BUILDTREES_DIR}/cmake-vars-${TARGET_TRIPLET}-rel.cmake.log"
+            PREFER_NINJA
+            LOGNAME get-cmake-vars-${TARGET_TRIPLET}
+        )
+
+        # Write the entry under a temporary name, so that concurrent builds never read a partial entry.
+        z_vcpkg_internal_get_cmake_vars_fingerprint(_gcv_FINGERPRINT ${_gcv_VARS_FILES})
+        string(RANDOM LENGTH 8 _gcv_SUFFIX)
+        set(_gcv_TEMP_DIR "${_gcv_CACHE_DIR}.${_gcv_SUFFIX}.tmp")
+        file(REMOVE_RECURSE "${_gcv_CACHE_DIR}")
+        file(COPY ${_gcv_VARS_FILES} DESTINATION "${_gcv_TEMP_DIR}")
+        file(WRITE "${_gcv_TEMP_DIR}/fingerprint.txt" "${_gcv_FINGERPRINT}")
+        execute_process(
+            COMMAND "${CMAKE_COMMAND}" -E rename "${_gcv_TEMP_DIR}" "${_gcv_CACHE_DIR}"
+            OUTPUT_QUIET ERROR_QUIET
+        )
+        file(REMOVE_RECURSE "${_gcv_TEMP_DIR}")
+    endif()
+
+    set(_include_string)
+    foreach(_gcv_VARS_FILE IN LISTS _gcv_VARS_FILES)
+        string(APPEND _include_string "include(\"${_gcv_VARS_FILE}\")\n")
+    endforeach()
     file(WRITE "${${_gcv_OUTPUT_FILE}}" "${_include_string}")
 
 endfunction()
@@ -35,6 +35,7 @@ function(z_vcpkg_apply_patches)
         message(FATAL_ERROR "internal error: z_vcpkg_apply_patches was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
     endif()
 
+    z_vcpkg_trace_begin("apply_patches" CATEGORY patch)
     find_program(GIT NAMES git git.cmd REQUIRED)
     if(DEFINED ENV{GIT_CONFIG_NOSYSTEM})
         set(git_config_nosystem_backup "$ENV{GIT_CONFIG_NOSYSTEM}")
@@ -68,4 +69,5 @@ function(z_vcpkg_apply_patches)
     else()
         unset(ENV{GIT_CONFIG_NOSYSTEM})
     endif()
+    z_vcpkg_trace_end("apply_patches" CATEGORY patch)
 endfunction()
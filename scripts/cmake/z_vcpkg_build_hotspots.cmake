@@ -0,0 +1,234 @@
+#[===[.md:
+# z_vcpkg_build_hotspots
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Report the slowest steps of the Ninja builds of a port.
+
+```cmake
+z_vcpkg_build_hotspots_begin()
+z_vcpkg_build_hotspots_end()
+```
+
+If the triplet sets `VCPKG_TIME_TRACE`, `z_vcpkg_build_hotspots_begin` appends `-ftime-trace`
+to `VCPKG_C_FLAGS` and `VCPKG_CXX_FLAGS` for each language whose detected compiler is clang,
+so that clang writes a trace of every translation unit it compiles next to the object file.
+Other compilers reject the flag, so it is not added for them.
+
+`z_vcpkg_build_hotspots_end` copies the `.ninja_log` of the `${TARGET_TRIPLET}-rel` and `${TARGET_TRIPLET}-dbg`
+build directories to `ninja-log-${TARGET_TRIPLET}-<rel|dbg>.log` in the buildtree of the port,
+and writes `build-hotspots-${TARGET_TRIPLET}.log` next to them.
+The report ranks the slowest compile steps, link steps and other steps, such as code generators,
+of both configurations. Steps which ran more than once, for example because the build was restarted, are counted once.
+If the objects were compiled with `-ftime-trace`, the report also ranks the headers
+by the total time spent parsing them, including the headers they include, over all translation units.
+
+Ports which are not built with Ninja have no `.ninja_log`, and no report is written for them.
+#]===]
+
+set(Z_VCPKG_BUILD_HOTSPOTS_COUNT 25)
+
+function(z_vcpkg_build_hotspots_begin)
+    if(NOT VCPKG_TIME_TRACE)
+        return()
+    endif()
+    vcpkg_internal_get_cmake_vars(OUTPUT_FILE cmake_vars_file)
+    include("${cmake_vars_file}")
+    set(time_trace OFF)
+    foreach(lang IN ITEMS C CXX)
+        if(VCPKG_DETECTED_CMAKE_${lang}_COMPILER_ID STREQUAL "Clang")
+            string(APPEND VCPKG_${lang}_FLAGS " -ftime-trace")
+            set(VCPKG_${lang}_FLAGS "${VCPKG_${lang}_FLAGS}" PARENT_SCOPE)
+            set(time_trace ON)
+        endif()
+    endforeach()
+    if(NOT time_trace)
+        message(STATUS "VCPKG_TIME_TRACE requires clang; not compiling ${PORT} with -ftime-trace")
+    endif()
+    set(Z_VCPKG_BUILD_HOTSPOTS_TIME_TRACE "${time_trace}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_build_hotspots_format_ms out_var ms)
+    math(EXPR seconds "${ms} / 1000")
+    math(EXPR milliseconds "${ms} % 1000")
+    string(LENGTH "${milliseconds}" length)
+    if(length EQUAL "1")
+        set(milliseconds "00${milliseconds}")
+    elseif(length EQUAL "2")
+        set(milliseconds "0${milliseconds}")
+    endif()
+    set(formatted "${seconds}.${milliseconds}s")
+    string(LENGTH "${formatted}" length)
+    while(length LESS "10")
+        set(formatted " ${formatted}")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set("${out_var}" "${formatted}" PARENT_SCOPE)
+endfunction()
+
+# Zero-pads a duration, so that entries starting with it sort by duration.
+function(z_vcpkg_build_hotspots_sort_key out_var value)
+    string(LENGTH "${value}" length)
+    while(length LESS "12")
+        set(value "0${value}")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set("${out_var}" "${value}" PARENT_SCOPE)
+endfunction()
+
+# Appends the steps of a .ninja_log to <out_var>, as "<ms>\t<config>\t<kind>\t<output>" entries.
+function(z_vcpkg_build_hotspots_read_ninja_log out_var ninja_log config)
+    file(STRINGS "${ninja_log}" lines)
+    # Later lines are from later builds; keep only the last run of each output.
+    list(REVERSE lines)
+    set(steps "${${out_var}}")
+    set(objects "${${out_var}_OBJECTS}")
+    foreach(line IN LISTS lines)
+        if(NOT line MATCHES "^([0-9]+)\t([0-9]+)\t[0-9]+\t([^\t]+)\t([0-9a-f]+)$")
+            continue()
+        endif()
+        set(start "${CMAKE_MATCH_1}")
+        set(end "${CMAKE_MATCH_2}")
+        set(output "${CMAKE_MATCH_3}")
+        # A command with several outputs has a line for each of them.
+        set(command "${CMAKE_MATCH_4}-${start}-${end}")
+        if(DEFINED "seen_output_${output}" OR DEFINED "seen_command_${command}")
+            continue()
+        endif()
+        set("seen_output_${output}" ON)
+        set("seen_command_${command}" ON)
+
+        math(EXPR duration "${end} - ${start}")
+        if(output MATCHES "\\.(o|obj|pch|gch)$")
+            set(kind compile)
+            list(APPEND objects "${output}")
+        elseif(output MATCHES "\\.(a|lib|so|so\\.[0-9.]+|dylib|dll|exe)$" OR NOT output MATCHES "\\.[^/]*$")
+            set(kind link)
+        else()
+            set(kind other)
+        endif()
+        z_vcpkg_build_hotspots_sort_key(key "${duration}")
+        list(APPEND steps "${key}\t${config}\t${kind}\t${output}")
+    endforeach()
+    set("${out_var}" "${steps}" PARENT_SCOPE)
+    set("${out_var}_OBJECTS" "${objects}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_build_hotspots_format_steps out_var steps kind title)
+    set(report "${title}:\n")
+    set(count 0)
+    set(total 0)
+    foreach(step IN LISTS steps)
+        if(NOT step MATCHES "^([0-9]+)\t([a-z]+)\t${kind}\t(.*)$")
+            continue()
+        endif()
+        math(EXPR duration "${CMAKE_MATCH_1}")
+        math(EXPR total "${total} + ${duration}")
+        math(EXPR count "${count} + 1")
+        if(count GREATER Z_VCPKG_BUILD_HOTSPOTS_COUNT)
+            continue()
+        endif()
+        z_vcpkg_build_hotspots_format_ms(duration "${duration}")
+        string(APPEND report "${duration}  ${CMAKE_MATCH_2}  ${CMAKE_MATCH_3}\n")
+    endforeach()
+    if(count EQUAL "0")
+        set("${out_var}" "" PARENT_SCOPE)
+        return()
+    endif()
+    z_vcpkg_build_hotspots_format_ms(total "${total}")
+    string(STRIP "${total}" total)
+    string(APPEND report "(${count} steps, ${total} in total)\n\n")
+    set("${out_var}" "${report}" PARENT_SCOPE)
+endfunction()
+
+# Adds up the time clang spent in each header, from the -ftime-trace output of the given objects,
+# as "<us>\t<count>\t<header>" entries.
+function(z_vcpkg_build_hotspots_read_time_traces out_var)
+    set(headers "")
+    set(traces 0)
+    foreach(object IN LISTS ARGN)
+        string(REGEX REPLACE "\\.[^./]+$" ".json" trace "${object}")
+        if(NOT EXISTS "${trace}")
+            continue()
+        endif()
+        math(EXPR traces "${traces} + 1")
+        file(READ "${trace}" contents)
+        # Written by clang as {"pid":..,"tid":..,"ph":"X","ts":..,"dur":..,"name":"Source","args":{"detail":"<file>"}}
+        string(REGEX MATCHALL "\"dur\":[0-9]+,\"name\":\"Source\",\"args\":{\"detail\":\"[^\"]*\"" events "${contents}")
+        foreach(event IN LISTS events)
+            string(REGEX MATCH "^\"dur\":([0-9]+),.*\"detail\":\"(.*)\"$" unused "${event}")
+            set(header "${CMAKE_MATCH_2}")
+            string(REPLACE "\\\\" "\\" header "${header}")
+            if(NOT DEFINED "header_time_${header}")
+                list(APPEND headers "${header}")
+                set("header_time_${header}" 0)
+                set("header_count_${header}" 0)
+            endif()
+            math(EXPR "header_time_${header}" "${header_time_${header}} + ${CMAKE_MATCH_1}")
+            math(EXPR "header_count_${header}" "${header_count_${header}} + 1")
+        endforeach()
+    endforeach()
+
+    set(entries "")
+    foreach(header IN LISTS headers)
+        z_vcpkg_build_hotspots_sort_key(key "${header_time_${header}}")
+        list(APPEND entries "${key}\t${header_count_${header}}\t${header}")
+    endforeach()
+    set("${out_var}" "${entries}" PARENT_SCOPE)
+    set("${out_var}_TRACES" "${traces}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_build_hotspots_end)
+    set(steps "")
+    set(objects "")
+    foreach(config IN ITEMS rel dbg)
+        set(build_dir "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-${config}")
+        if(NOT EXISTS "${build_dir}/.ninja_log")
+            continue()
+        endif()
+        configure_file("${build_dir}/.ninja_log" "${CURRENT_BUILDTREES_DIR}/ninja-log-${TARGET_TRIPLET}-${config}.log" COPYONLY)
+        set(steps_OBJECTS "")
+        z_vcpkg_build_hotspots_read_ninja_log(steps "${build_dir}/.ninja_log" "${config}")
+        foreach(object IN LISTS steps_OBJECTS)
+            if(NOT IS_ABSOLUTE "${object}")
+                set(object "${build_dir}/${object}")
+            endif()
+            list(APPEND objects "${object}")
+        endforeach()
+    endforeach()
+    if(steps STREQUAL "")
+        return()
+    endif()
+
+    list(SORT steps)
+    list(REVERSE steps)
+    set(report "Build hotspots of ${PORT}:${TARGET_TRIPLET}\n\n")
+    z_vcpkg_build_hotspots_format_steps(section "${steps}" compile "Slowest compile steps")
+    string(APPEND report "${section}")
+    z_vcpkg_build_hotspots_format_steps(section "${steps}" link "Slowest link steps")
+    string(APPEND report "${section}")
+    z_vcpkg_build_hotspots_format_steps(section "${steps}" other "Slowest other steps")
+    string(APPEND report "${section}")
+
+    if(Z_VCPKG_BUILD_HOTSPOTS_TIME_TRACE)
+        z_vcpkg_build_hotspots_read_time_traces(headers ${objects})
+        list(SORT headers)
+        list(REVERSE headers)
+        list(LENGTH headers header_count)
+        string(APPEND report "Most expensive headers (-ftime-trace of ${headers_TRACES} translation units):\n")
+        set(count 0)
+        foreach(entry IN LISTS headers)
+            math(EXPR count "${count} + 1")
+            if(count GREATER Z_VCPKG_BUILD_HOTSPOTS_COUNT)
+                break()
+            endif()
+            string(REGEX MATCH "^([0-9]+)\t([0-9]+)\t(.*)$" unused "${entry}")
+            math(EXPR milliseconds "${CMAKE_MATCH_1} / 1000")
+            z_vcpkg_build_hotspots_format_ms(duration "${milliseconds}")
+            string(APPEND report "${duration}  ${CMAKE_MATCH_2}x  ${CMAKE_MATCH_3}\n")
+        endforeach()
+        string(APPEND report "(${header_count} headers)\n\n")
+    endif()
+
+    file(WRITE "${CURRENT_BUILDTREES_DIR}/build-hotspots-${TARGET_TRIPLET}.log" "${report}")
+endfunction()
@@ -0,0 +1,62 @@
+#[===[.md:
+# z_vcpkg_check_linker
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Check that the binaries of a port were linked by the linker selected by the triplet.
+
+```cmake
+z_vcpkg_check_linker()
+```
+
+If the triplet sets `VCPKG_LINKER` for a Linux target, `z_vcpkg_check_linker` looks at every ELF executable
+and shared library in `${CURRENT_PACKAGES_DIR}`, and determines the linker which produced it:
+* `lld` writes `Linker: LLD` to the `.comment` section,
+* `mold` writes its name and version to the `.comment` section,
+* `gold` adds a `.note.gnu.gold-version` section,
+* GNU `ld` (`bfd`) leaves no mark, and is assumed if none of the above is found.
+
+The binaries which were linked by another linker, for example because the build system of the port
+chooses the linker itself, are listed in a warning.
+The check requires `readelf`; if it is not found, it is skipped.
+Static libraries are not linked, and are not checked.
+#]===]
+
+function(z_vcpkg_check_linker)
+    if(NOT VCPKG_LINKER OR NOT VCPKG_TARGET_IS_LINUX OR NOT EXISTS "${CURRENT_PACKAGES_DIR}")
+        return()
+    endif()
+    find_program(Z_VCPKG_READELF NAMES readelf llvm-readelf)
+    if(NOT Z_VCPKG_READELF)
+        message(STATUS "readelf not found; not checking that the binaries were linked by ${VCPKG_LINKER}")
+        return()
+    endif()
+
+    z_vcpkg_find_elf_binaries(binaries "${CURRENT_PACKAGES_DIR}")
+    set(mismatched "")
+    foreach(file IN LISTS binaries)
+        execute_process(
+            COMMAND "${Z_VCPKG_READELF}" -W -S -p .comment "${file}"
+            OUTPUT_VARIABLE output
+            ERROR_QUIET
+        )
+        if(output MATCHES "Linker: LLD")
+            set(linker lld)
+        elseif(output MATCHES "\\] *mold ")
+            set(linker mold)
+        elseif(output MATCHES "\\.note\\.gnu\\.gold-version")
+            set(linker gold)
+        else()
+            set(linker bfd)
+        endif()
+        if(NOT linker STREQUAL VCPKG_LINKER)
+            file(RELATIVE_PATH file "${CURRENT_PACKAGES_DIR}" "${file}")
+            list(APPEND mismatched "${file} (${linker})")
+        endif()
+    endforeach()
+
+    if(NOT mismatched STREQUAL "")
+        list(JOIN mismatched "\n    " mismatched)
+        message(WARNING "VCPKG_LINKER is set to ${VCPKG_LINKER}, but the following binaries were linked by another linker:\n    ${mismatched}")
+    endif()
+endfunction()
@@ -0,0 +1,197 @@
+#[===[.md:
+# z_vcpkg_compiler_cache
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Set up a compiler cache for the build of a port.
+
+```cmake
+z_vcpkg_compiler_cache_begin()
+z_vcpkg_compiler_cache_end()
+```
+
+`z_vcpkg_compiler_cache_begin` reads `VCPKG_COMPILER_CACHE` from the triplet,
+or from the environment if the triplet does not set it.
+It may be `ccache`, `sccache`, or the full path to either of them.
+If it is set, the function writes a launcher script for each build type,
+and stores their paths in `Z_VCPKG_COMPILER_CACHE_LAUNCHER_RELEASE`
+and `Z_VCPKG_COMPILER_CACHE_LAUNCHER_DEBUG`.
+Build system helpers pass these launchers on:
+`vcpkg_cmake_configure` and `vcpkg_configure_cmake` as `VCPKG_COMPILER_CACHE_LAUNCHER`
+(used by `scripts/toolchains/linux.cmake`),
+`vcpkg_configure_make` in `CC` and `CXX`,
+and `vcpkg_configure_meson` in the `c` and `cpp` entries of the native or cross files.
+
+Each launcher points the cache at its own directory below
+`VCPKG_COMPILER_CACHE_DIR`, which defaults to `${DOWNLOADS}/compiler-cache`:
+`<triplet>/rel` and `<triplet>/dbg` for ccache.
+sccache reads the directory when its server starts, so it is given `<triplet>` only,
+and debug and release objects are kept apart by its hash of the command line.
+Each sccache directory gets a dedicated server, listening on a port (`SCCACHE_SERVER_PORT`)
+derived from the path of the directory; a server which is already running is reused,
+and servers of other users or vcpkg roots are left alone.
+
+`z_vcpkg_compiler_cache_end` writes the hit and miss statistics of the port
+to `compiler-cache-<triplet>-<rel|dbg>.log` (ccache)
+or `compiler-cache-<triplet>.log` (sccache) in the buildtree of the port.
+
+The compiler cache is not used on Windows hosts.
+#]===]
+
+function(z_vcpkg_compiler_cache_write_launcher out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "" "PROGRAM;NAME;CACHE_DIR;CACHE_DIR_VAR;LAUNCHER_DIR" "ENV")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_compiler_cache_write_launcher was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+
+    # The launcher keeps the name of the cache program, so that meson still recognizes it.
+    file(MAKE_DIRECTORY "${arg_CACHE_DIR}")
+    set(env_lines "")
+    foreach(env IN LISTS arg_ENV)
+        string(REGEX MATCH "^[^=]*" env_var "${env}")
+        string(APPEND env_lines "${env}\nexport ${env_var}\n")
+    endforeach()
+    file(WRITE "${arg_LAUNCHER_DIR}/tmp/${arg_NAME}"
+        "#!/bin/sh\n"
+        "${arg_CACHE_DIR_VAR}='${arg_CACHE_DIR}'\n"
+        "export ${arg_CACHE_DIR_VAR}\n"
+        "${env_lines}"
+        "exec '${arg_PROGRAM}' \"$@\"\n"
+    )
+    file(COPY "${arg_LAUNCHER_DIR}/tmp/${arg_NAME}"
+        DESTINATION "${arg_LAUNCHER_DIR}"
+        FILE_PERMISSIONS OWNER_READ OWNER_WRITE OWNER_EXECUTE GROUP_READ GROUP_EXECUTE WORLD_READ WORLD_EXECUTE
+    )
+    file(REMOVE_RECURSE "${arg_LAUNCHER_DIR}/tmp")
+    set("${out_var}" "${arg_LAUNCHER_DIR}/${arg_NAME}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_compiler_cache_begin)
+    if(DEFINED ARGN AND NOT ARGN STREQUAL "")
+        message(FATAL_ERROR "internal error: z_vcpkg_compiler_cache_begin was passed extra arguments: ${ARGN}")
+    endif()
+
+    if(NOT DEFINED VCPKG_COMPILER_CACHE AND DEFINED ENV{VCPKG_COMPILER_CACHE})
+        set(VCPKG_COMPILER_CACHE "$ENV{VCPKG_COMPILER_CACHE}")
+    endif()
+    if(NOT DEFINED VCPKG_COMPILER_CACHE_DIR AND DEFINED ENV{VCPKG_COMPILER_CACHE_DIR})
+        set(VCPKG_COMPILER_CACHE_DIR "$ENV{VCPKG_COMPILER_CACHE_DIR}")
+    endif()
+    if(NOT VCPKG_COMPILER_CACHE)
+        return()
+    endif()
+    if(CMAKE_HOST_WIN32)
+        message(WARNING "VCPKG_COMPILER_CACHE is not supported on Windows hosts and will be ignored.")
+        return()
+    endif()
+
+    find_program(Z_VCPKG_COMPILER_CACHE_PROGRAM NAMES "${VCPKG_COMPILER_CACHE}")
+    if(NOT Z_VCPKG_COMPILER_CACHE_PROGRAM)
+        message(FATAL_ERROR "Could not find the compiler cache '${VCPKG_COMPILER_CACHE}' set by VCPKG_COMPILER_CACHE.")
+    endif()
+    get_filename_component(name "${Z_VCPKG_COMPILER_CACHE_PROGRAM}" NAME)
+    if(name MATCHES "^sccache")
+        set(kind sccache)
+        set(cache_dir_var SCCACHE_DIR)
+    elseif(name MATCHES "^ccache")
+        set(kind ccache)
+        set(cache_dir_var CCACHE_DIR)
+    else()
+        message(FATAL_ERROR "VCPKG_COMPILER_CACHE must be ccache or sccache; got '${VCPKG_COMPILER_CACHE}'.")
+    endif()
+
+    if(NOT VCPKG_COMPILER_CACHE_DIR)
+        set(VCPKG_COMPILER_CACHE_DIR "${DOWNLOADS}/compiler-cache")
+    endif()
+    file(TO_CMAKE_PATH "${VCPKG_COMPILER_CACHE_DIR}" cache_root)
+
+    set(launcher_root "${CURRENT_BUILDTREES_DIR}/vcpkg-compiler-cache")
+    file(REMOVE_RECURSE "${launcher_root}")
+
+    set(launcher_env "")
+    if(kind STREQUAL "sccache")
+        # The server reads SCCACHE_DIR when it starts, so each cache directory gets its own server.
+        # Its port is derived from the directory, which keeps it apart from the default server and other vcpkg roots.
+        set(cache_dir "${cache_root}/${TARGET_TRIPLET}")
+        file(MAKE_DIRECTORY "${cache_dir}")
+        string(SHA1 cache_dir_hash "${cache_dir}")
+        string(SUBSTRING "${cache_dir_hash}" 0 6 cache_dir_hash)
+        math(EXPR server_port "20000 + (0x${cache_dir_hash} % 40000)")
+        set(launcher_env "SCCACHE_SERVER_PORT=${server_port}")
+        # Fails without harm if the server of this directory is already running.
+        execute_process(
+            COMMAND "${CMAKE_COMMAND}" -E env "SCCACHE_DIR=${cache_dir}" ${launcher_env}
+                "${Z_VCPKG_COMPILER_CACHE_PROGRAM}" --start-server
+            OUTPUT_QUIET ERROR_QUIET
+        )
+        execute_process(
+            COMMAND "${CMAKE_COMMAND}" -E env ${launcher_env}
+                "${Z_VCPKG_COMPILER_CACHE_PROGRAM}" --zero-stats
+            OUTPUT_QUIET ERROR_QUIET
+        )
+    endif()
+
+    foreach(buildtype IN ITEMS RELEASE DEBUG)
+        if(buildtype STREQUAL "RELEASE")
+            set(short_buildtype "rel")
+        else()
+            set(short_buildtype "dbg")
+        endif()
+        if(kind STREQUAL "ccache")
+            set(cache_dir "${cache_root}/${TARGET_TRIPLET}/${short_buildtype}")
+        endif()
+        z_vcpkg_compiler_cache_write_launcher(launcher
+            PROGRAM "${Z_VCPKG_COMPILER_CACHE_PROGRAM}"
+            NAME "${kind}"
+            CACHE_DIR "${cache_dir}"
+            CACHE_DIR_VAR "${cache_dir_var}"
+            LAUNCHER_DIR "${launcher_root}/${short_buildtype}"
+            ENV ${launcher_env}
+        )
+        if(kind STREQUAL "ccache")
+            execute_process(
+                COMMAND "${launcher}" --zero-stats
+                OUTPUT_QUIET ERROR_QUIET
+            )
+        endif()
+        set(Z_VCPKG_COMPILER_CACHE_LAUNCHER_${buildtype} "${launcher}" PARENT_SCOPE)
+    endforeach()
+
+    message(STATUS "Using ${kind} from ${Z_VCPKG_COMPILER_CACHE_PROGRAM}")
+endfunction()
+
+function(z_vcpkg_compiler_cache_end)
+    if(NOT DEFINED Z_VCPKG_COMPILER_CACHE_LAUNCHER_RELEASE)
+        return()
+    endif()
+
+    get_filename_component(kind "${Z_VCPKG_COMPILER_CACHE_LAUNCHER_RELEASE}" NAME)
+    if(kind STREQUAL "sccache")
+        execute_process(
+            COMMAND "${Z_VCPKG_COMPILER_CACHE_LAUNCHER_RELEASE}" --show-stats
+            OUTPUT_FILE "${CURRENT_BUILDTREES_DIR}/compiler-cache-${TARGET_TRIPLET}.log"
+            ERROR_VARIABLE error
+            RESULT_VARIABLE error_code
+        )
+    else()
+        foreach(short_buildtype IN ITEMS rel dbg)
+            if(short_buildtype STREQUAL "rel")
+                set(launcher "${Z_VCPKG_COMPILER_CACHE_LAUNCHER_RELEASE}")
+            else()
+                set(launcher "${Z_VCPKG_COMPILER_CACHE_LAUNCHER_DEBUG}")
+            endif()
+            execute_process(
+                COMMAND "${launcher}" --show-stats
+                OUTPUT_FILE "${CURRENT_BUILDTREES_DIR}/compiler-cache-${TARGET_TRIPLET}-${short_buildtype}.log"
+                ERROR_VARIABLE error
+                RESULT_VARIABLE error_code
+            )
+            if(error_code)
+                break()
+            endif()
+        endforeach()
+    endif()
+    if(error_code)
+        message(WARNING "Unable to collect the statistics of the compiler cache:\n${error}")
+    endif()
+endfunction()
@@ -0,0 +1,241 @@
+#[===[.md:
+# z_vcpkg_concurrent_build
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Run the debug and release builds of a port at the same time.
+
+```cmake
+z_vcpkg_concurrent_build_begin(<out-jobs-var> [DISABLE])
+foreach(buildtype IN ITEMS debug release)
+    z_vcpkg_concurrent_build_add(
+        BUILD_TYPE <buildtype>
+        COMMAND <cmd> [<args>...]
+        [NO_PARALLEL_COMMAND <cmd> [<args>...]]
+        [JOBS <count>]
+        WORKING_DIRECTORY </path/to/dir>
+        LOGNAME <log_name>
+        [ENVIRONMENT <var>...]
+    )
+endforeach()
+z_vcpkg_concurrent_build_end()
+```
+
+`z_vcpkg_concurrent_build_begin` stores the number of jobs each build may use in `<out-jobs-var>`,
+as computed by [`z_vcpkg_get_build_jobs()`](z_vcpkg_get_build_jobs.md) from `VCPKG_CONCURRENCY`
+and the available memory.
+If the triplet sets `VCPKG_CONCURRENT_BUILD_TYPES` and both build types are being built,
+these jobs are split between the two build types, unless `DISABLE` is passed.
+
+`z_vcpkg_concurrent_build_add` takes the same arguments as
+[`vcpkg_execute_build_process()`](../vcpkg_execute_build_process.md).
+When concurrent builds are not enabled, it simply forwards to that function.
+Otherwise, the command is queued, together with the current values of `PATH`
+and of each environment variable named in `ENVIRONMENT`.
+Commands with the same `BUILD_TYPE` run one after the other, in the order they were added.
+
+`z_vcpkg_concurrent_build_end` runs the queued commands of each build type in parallel
+through a generated `vcpkg-concurrent-build/build.ninja`.
+Each command keeps its own log, named after its `LOGNAME`, as with `vcpkg_execute_build_process`.
+In the [build trace](z_vcpkg_trace.md), each build type is shown as a thread of its own.
+Commands which failed, or which did not run because an earlier command of their build type failed,
+are run again one at a time, so that failures caused by the higher combined memory use are recovered from.
+
+## Examples
+
+* [vcpkg_build_make](https://github.com/Microsoft/vcpkg/blob/master/scripts/cmake/vcpkg_build_make.cmake)
+* [vcpkg_install_meson](https://github.com/Microsoft/vcpkg/blob/master/scripts/cmake/vcpkg_install_meson.cmake)
+#]===]
+
+function(z_vcpkg_concurrent_build_quote out_var value)
+    set(equals "")
+    while(value MATCHES "]${equals}]")
+        string(APPEND equals "=")
+    endwhile()
+    set("${out_var}" "[${equals}[${value}]${equals}]" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_concurrent_build_begin out_jobs_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "DISABLE" "" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_concurrent_build_begin was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+
+    set_property(GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_ACTIVE OFF)
+    set_property(GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_JOBS "")
+    set_property(GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_TYPES "")
+
+    if(NOT VCPKG_CONCURRENT_BUILD_TYPES OR arg_DISABLE OR DEFINED VCPKG_BUILD_TYPE)
+        z_vcpkg_get_build_jobs(jobs)
+        set("${out_jobs_var}" "${jobs}" PARENT_SCOPE)
+        return()
+    endif()
+
+    z_vcpkg_get_build_jobs(jobs CONCURRENT_BUILDS 2)
+
+    set(job_dir "${CURRENT_BUILDTREES_DIR}/vcpkg-concurrent-build")
+    file(REMOVE_RECURSE "${job_dir}")
+    file(MAKE_DIRECTORY "${job_dir}")
+
+    set_property(GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_ACTIVE ON)
+    set("${out_jobs_var}" "${jobs}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_concurrent_build_add)
+    cmake_parse_arguments(PARSE_ARGV 0 "arg" "" "BUILD_TYPE;WORKING_DIRECTORY;LOGNAME;JOBS" "COMMAND;NO_PARALLEL_COMMAND;ENVIRONMENT")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_concurrent_build_add was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    foreach(required_arg IN ITEMS BUILD_TYPE COMMAND WORKING_DIRECTORY LOGNAME)
+        if(NOT DEFINED arg_${required_arg})
+            message(FATAL_ERROR "internal error: z_vcpkg_concurrent_build_add requires ${required_arg}")
+        endif()
+    endforeach()
+
+    set(no_parallel_command_param "")
+    if(DEFINED arg_NO_PARALLEL_COMMAND)
+        set(no_parallel_command_param NO_PARALLEL_COMMAND ${arg_NO_PARALLEL_COMMAND})
+    endif()
+    set(jobs_param "")
+    if(DEFINED arg_JOBS)
+        set(jobs_param JOBS "${arg_JOBS}")
+    endif()
+
+    get_property(active GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_ACTIVE)
+    if(NOT active)
+        vcpkg_execute_build_process(
+            COMMAND ${arg_COMMAND}
+            ${no_parallel_command_param}
+            ${jobs_param}
+            WORKING_DIRECTORY "${arg_WORKING_DIRECTORY}"
+            LOGNAME "${arg_LOGNAME}"
+        )
+        return()
+    endif()
+
+    # Each build type is traced as a thread of its own, after the thread of the portfile.
+    get_property(build_types GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_TYPES)
+    list(FIND build_types "${arg_BUILD_TYPE}" build_type_index)
+    if(build_type_index EQUAL "-1")
+        list(LENGTH build_types build_type_index)
+        set_property(GLOBAL APPEND PROPERTY Z_VCPKG_CONCURRENT_BUILD_TYPES "${arg_BUILD_TYPE}")
+        math(EXPR trace_thread "${build_type_index} + 2")
+        z_vcpkg_trace_name_thread("${trace_thread}" "${arg_BUILD_TYPE}")
+    endif()
+    math(EXPR Z_VCPKG_TRACE_THREAD "${build_type_index} + 2")
+
+    # Each job is a self-contained script, so that it can be run by ninja and rerun on its own.
+    set(contents "# Generated by z_vcpkg_concurrent_build_add\n")
+    foreach(var IN ITEMS SCRIPTS CURRENT_BUILDTREES_DIR TARGET_TRIPLET PORT Z_VCPKG_TRACE_FILE Z_VCPKG_TRACE_THREAD)
+        if(NOT DEFINED "${var}")
+            continue()
+        endif()
+        z_vcpkg_concurrent_build_quote(value "${${var}}")
+        string(APPEND contents "set(${var} ${value})\n")
+    endforeach()
+    string(APPEND contents
+        "include(\"\${SCRIPTS}/cmake/z_vcpkg_function_arguments.cmake\")\n"
+        "include(\"\${SCRIPTS}/cmake/z_vcpkg_prettify_command_line.cmake\")\n"
+        "include(\"\${SCRIPTS}/cmake/z_vcpkg_resource_usage.cmake\")\n"
+        "include(\"\${SCRIPTS}/cmake/z_vcpkg_trace.cmake\")\n"
+        "include(\"\${SCRIPTS}/cmake/vcpkg_execute_build_process.cmake\")\n"
+    )
+
+    set(environment PATH ${arg_ENVIRONMENT})
+    list(REMOVE_DUPLICATES environment)
+    foreach(var IN LISTS environment)
+        if(DEFINED ENV{${var}})
+            z_vcpkg_concurrent_build_quote(value "$ENV{${var}}")
+            string(APPEND contents "set(ENV{${var}} ${value})\n")
+        else()
+            string(APPEND contents "unset(ENV{${var}})\n")
+        endif()
+    endforeach()
+
+    string(APPEND contents "vcpkg_execute_build_process(\n    COMMAND")
+    foreach(arg IN LISTS arg_COMMAND)
+        z_vcpkg_concurrent_build_quote(value "${arg}")
+        string(APPEND contents " ${value}")
+    endforeach()
+    if(DEFINED arg_NO_PARALLEL_COMMAND)
+        string(APPEND contents "\n    NO_PARALLEL_COMMAND")
+        foreach(arg IN LISTS arg_NO_PARALLEL_COMMAND)
+            z_vcpkg_concurrent_build_quote(value "${arg}")
+            string(APPEND contents " ${value}")
+        endforeach()
+    endif()
+    if(DEFINED arg_JOBS)
+        string(APPEND contents "\n    JOBS ${arg_JOBS}")
+    endif()
+    z_vcpkg_concurrent_build_quote(working_directory "${arg_WORKING_DIRECTORY}")
+    z_vcpkg_concurrent_build_quote(logname "${arg_LOGNAME}")
+    string(APPEND contents
+        "\n    WORKING_DIRECTORY ${working_directory}"
+        "\n    LOGNAME ${logname}"
+        "\n)\n"
+        "file(TOUCH \"\${CMAKE_CURRENT_LIST_DIR}/${arg_LOGNAME}.stamp\")\n"
+    )
+    file(WRITE "${CURRENT_BUILDTREES_DIR}/vcpkg-concurrent-build/${arg_LOGNAME}.cmake" "${contents}")
+
+    set_property(GLOBAL APPEND PROPERTY Z_VCPKG_CONCURRENT_BUILD_JOBS "${arg_BUILD_TYPE}" "${arg_LOGNAME}")
+endfunction()
+
+function(z_vcpkg_concurrent_build_end)
+    get_property(active GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_ACTIVE)
+    get_property(jobs GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_JOBS)
+    set_property(GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_ACTIVE OFF)
+    set_property(GLOBAL PROPERTY Z_VCPKG_CONCURRENT_BUILD_JOBS "")
+    if(NOT active OR jobs STREQUAL "")
+        return()
+    endif()
+
+    set(job_dir "${CURRENT_BUILDTREES_DIR}/vcpkg-concurrent-build")
+    string(REPLACE "$" "$$" cmake_command "${CMAKE_COMMAND}")
+    set(contents "rule RunJob\n  command = \"${cmake_command}\" -P $in\n  description = $in\n\n")
+
+    set(build_types "")
+    set(lognames "")
+    while(NOT jobs STREQUAL "")
+        list(POP_FRONT jobs build_type logname)
+        if(DEFINED last_stamp_${build_type})
+            set(order_only " || ${last_stamp_${build_type}}")
+        else()
+            set(order_only "")
+            list(APPEND build_types "${build_type}")
+        endif()
+        string(APPEND contents "build ${logname}.stamp: RunJob ${logname}.cmake${order_only}\n\n")
+        set(last_stamp_${build_type} "${logname}.stamp")
+        list(APPEND lognames "${logname}")
+    endwhile()
+    file(WRITE "${job_dir}/build.ninja" "${contents}")
+
+    list(LENGTH build_types build_type_count)
+    list(JOIN build_types " and " build_types_pretty)
+    message(STATUS "Building ${TARGET_TRIPLET} ${build_types_pretty} concurrently")
+
+    vcpkg_find_acquire_program(NINJA)
+    execute_process(
+        COMMAND "${NINJA}" -v -k 0 -j "${build_type_count}"
+        WORKING_DIRECTORY "${job_dir}"
+        OUTPUT_FILE "${CURRENT_BUILDTREES_DIR}/concurrent-build-${TARGET_TRIPLET}-out.log"
+        ERROR_FILE "${CURRENT_BUILDTREES_DIR}/concurrent-build-${TARGET_TRIPLET}-err.log"
+        RESULT_VARIABLE error_code
+    )
+    if(NOT error_code)
+        return()
+    endif()
+
+    foreach(logname IN LISTS lognames)
+        if(EXISTS "${job_dir}/${logname}.stamp")
+            continue()
+        endif()
+        message(STATUS "Rerunning ${logname} on its own")
+        execute_process(
+            COMMAND "${CMAKE_COMMAND}" -P "${job_dir}/${logname}.cmake"
+            RESULT_VARIABLE error_code
+        )
+        if(error_code)
+            message(FATAL_ERROR "Building ${logname} failed; see the messages above for details.")
+        endif()
+    endforeach()
+endfunction()
@@ -0,0 +1,33 @@
+#[===[.md:
+# z_vcpkg_find_elf_binaries
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Find the ELF executables and shared libraries below a directory.
+
+```cmake
+z_vcpkg_find_elf_binaries(<out-var> <directory>)
+```
+
+`z_vcpkg_find_elf_binaries` sets `<out-var>` to the absolute paths of the files below `<directory>`
+whose header identifies them as ELF executables or shared libraries, in either byte order.
+Symbolic links, object files and static libraries are not included.
+#]===]
+
+function(z_vcpkg_find_elf_binaries out_var directory)
+    set(binaries "")
+    if(EXISTS "${directory}")
+        file(GLOB_RECURSE files LIST_DIRECTORIES false "${directory}/*")
+        foreach(file IN LISTS files)
+            if(IS_SYMLINK "${file}")
+                continue()
+            endif()
+            # e_ident starts with "\x7fELF"; e_type at offset 16 is ET_EXEC (2) or ET_DYN (3).
+            file(READ "${file}" header LIMIT 18 HEX)
+            if(header MATCHES "^7f454c46.*(0200|0300|0002|0003)$")
+                list(APPEND binaries "${file}")
+            endif()
+        endforeach()
+    endif()
+    set("${out_var}" "${binaries}" PARENT_SCOPE)
+endfunction()
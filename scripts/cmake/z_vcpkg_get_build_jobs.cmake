@@ -0,0 +1,70 @@
+#[===[.md:
+# z_vcpkg_get_build_jobs
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Compute how many jobs a build may run at once without running out of memory.
+
+```cmake
+z_vcpkg_get_build_jobs(<out-var>
+    [LINK]
+    [CONCURRENT_BUILDS <count>]
+)
+```
+
+The result is `VCPKG_CONCURRENCY`, lowered so that the estimated memory use of the jobs
+fits into the physical memory which is currently available.
+Each compile job is estimated to use `VCPKG_COMPILE_JOB_MEMORY` MiB (512 by default);
+if `LINK` is passed, each job is estimated to use `VCPKG_LINK_JOB_MEMORY` MiB (2048 by default) instead.
+Triplets, and portfiles of ports with unusually large translation units or link steps,
+may set these variables to adjust the estimate.
+
+If `CONCURRENT_BUILDS` is passed, the jobs and the available memory are shared between
+`<count>` builds running at the same time, and the result is the share of one of them.
+
+The result is never less than 1.
+#]===]
+
+function(z_vcpkg_get_build_jobs out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "LINK" "CONCURRENT_BUILDS" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_get_build_jobs was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT DEFINED arg_CONCURRENT_BUILDS)
+        set(arg_CONCURRENT_BUILDS 1)
+    endif()
+
+    if(arg_LINK)
+        set(job_memory "${VCPKG_LINK_JOB_MEMORY}")
+        if(job_memory STREQUAL "")
+            set(job_memory 2048)
+        endif()
+    else()
+        set(job_memory "${VCPKG_COMPILE_JOB_MEMORY}")
+        if(job_memory STREQUAL "")
+            set(job_memory 512)
+        endif()
+    endif()
+    if(NOT job_memory MATCHES "^[0-9]+$" OR job_memory EQUAL "0")
+        message(FATAL_ERROR "The estimated memory per build job must be a positive number of MiB; got '${job_memory}'.")
+    endif()
+
+    set(jobs "${VCPKG_CONCURRENCY}")
+    if(NOT jobs MATCHES "^[0-9]+$" OR jobs EQUAL "0")
+        set(jobs 1)
+    endif()
+
+    cmake_host_system_information(RESULT available_memory QUERY AVAILABLE_PHYSICAL_MEMORY)
+    if(available_memory MATCHES "^[0-9]+$" AND available_memory GREATER "0")
+        math(EXPR memory_jobs "${available_memory} / ${job_memory}")
+        if(memory_jobs LESS jobs)
+            set(jobs "${memory_jobs}")
+        endif()
+    endif()
+
+    math(EXPR jobs "${jobs} / ${arg_CONCURRENT_BUILDS}")
+    if(jobs LESS "1")
+        set(jobs 1)
+    endif()
+    set("${out_var}" "${jobs}" PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,69 @@
+#[===[.md:
+# z_vcpkg_get_file_sha512
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Get the SHA512 of a file, without hashing it again if it has not changed since it was last hashed.
+
+```cmake
+z_vcpkg_get_file_sha512(<out-var> <file>)
+z_vcpkg_set_file_sha512(<file> <sha512>)
+```
+
+`z_vcpkg_get_file_sha512` sets `<out-var>` to the SHA512 of `<file>`, in lower case.
+The hash is recorded in a small sidecar file below `${DOWNLOADS}/verified-hashes`,
+together with the size and the modification time of `<file>`.
+As long as both are unchanged, later calls return the recorded hash instead of reading the file again,
+in the same build and in later ones.
+
+`z_vcpkg_set_file_sha512` records `<sha512>` as the hash of `<file>` without reading it,
+for callers which have just computed it, for example before renaming the file.
+
+The sidecar files may be deleted at any time.
+#]===]
+
+function(z_vcpkg_file_sha512_get_sidecar out_var out_stamp_var file)
+    get_filename_component(file "${file}" ABSOLUTE)
+    string(SHA1 path_hash "${file}")
+    file(SIZE "${file}" size)
+    file(TIMESTAMP "${file}" mtime "%s" UTC)
+    set("${out_var}" "${DOWNLOADS}/verified-hashes/${path_hash}.txt" PARENT_SCOPE)
+    set("${out_stamp_var}" "${size} ${mtime} ${file}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_set_file_sha512 file sha512)
+    if(NOT EXISTS "${file}")
+        message(FATAL_ERROR "internal error: z_vcpkg_set_file_sha512 was passed a file which does not exist: ${file}")
+    endif()
+    z_vcpkg_file_sha512_get_sidecar(sidecar stamp "${file}")
+    string(TOLOWER "${sha512}" sha512)
+
+    # Concurrent builds may record the same file; write to a temporary file so that readers never see a partial one.
+    string(RANDOM LENGTH 8 suffix)
+    file(WRITE "${sidecar}.${suffix}.tmp" "${sha512}\n${stamp}\n")
+    file(RENAME "${sidecar}.${suffix}.tmp" "${sidecar}")
+endfunction()
+
+function(z_vcpkg_get_file_sha512 out_var file)
+    if(NOT EXISTS "${file}")
+        message(FATAL_ERROR "internal error: z_vcpkg_get_file_sha512 was passed a file which does not exist: ${file}")
+    endif()
+    z_vcpkg_file_sha512_get_sidecar(sidecar stamp "${file}")
+
+    if(EXISTS "${sidecar}")
+        file(STRINGS "${sidecar}" recorded LIMIT_COUNT 2)
+        list(LENGTH recorded recorded_length)
+        if(recorded_length EQUAL "2")
+            list(GET recorded 0 recorded_sha512)
+            list(GET recorded 1 recorded_stamp)
+            if(recorded_stamp STREQUAL stamp AND recorded_sha512 MATCHES "^[0-9a-f]+$")
+                set("${out_var}" "${recorded_sha512}" PARENT_SCOPE)
+                return()
+            endif()
+        endif()
+    endif()
+
+    file(SHA512 "${file}" sha512)
+    z_vcpkg_set_file_sha512("${file}" "${sha512}")
+    set("${out_var}" "${sha512}" PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,233 @@
+#[===[.md:
+# z_vcpkg_resource_usage
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Measure the resources used by the processes a port build runs.
+
+```cmake
+z_vcpkg_resource_usage_begin(<prefix>)
+execute_process(COMMAND ${<prefix>_WRAPPER} <command>... )
+z_vcpkg_resource_usage_end(<prefix>
+    LOGNAME <log_name>
+    [WORKING_DIRECTORY </path/to/dir>]
+    [RETRIES <count>]
+)
+z_vcpkg_resource_usage_summarize(<out-var>)
+```
+
+`z_vcpkg_resource_usage_begin` takes a snapshot of the counters of the current CMake process,
+and sets `<prefix>_WRAPPER` to a command prefix which measures the peak memory use of the command it runs.
+`z_vcpkg_resource_usage_end` records the difference, together with the peak memory use of the wrapped commands,
+in `${CURRENT_BUILDTREES_DIR}/resource-usage-${TARGET_TRIPLET}.log`.
+Each record is attributed to the `dbg` or `rel` configuration if `<log_name>` or the working directory ends in
+`-dbg` or `-rel`, and to `other` otherwise.
+`<count>` is the number of times the command was restarted because it ran out of memory.
+
+The following is recorded for each process:
+* the user and system CPU time of the process and all its descendants,
+* the peak resident memory of the largest single process, in KiB,
+* the bytes read from and written to storage.
+
+`z_vcpkg_resource_usage_summarize` sets `<out-var>` to the totals of the records of the current port,
+one line per configuration, for `scripts/build_info.cmake`.
+
+Resources are measured on Linux only, from `/proc` for the CPU time and I/O of the children of the CMake process.
+The peak resident memory is only measured if GNU `time` is installed.
+On other systems, `<prefix>_WRAPPER` is empty and nothing is recorded.
+#]===]
+
+function(z_vcpkg_resource_usage_init)
+    file(REMOVE "${CURRENT_BUILDTREES_DIR}/resource-usage-${TARGET_TRIPLET}.log")
+endfunction()
+
+# Caches, per CMake process, how the counters of this process can be read.
+function(z_vcpkg_resource_usage_detect)
+    get_property(detected GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_DETECTED)
+    if(detected)
+        return()
+    endif()
+    set_property(GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_DETECTED ON)
+    set_property(GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_PID "")
+    if(NOT CMAKE_HOST_SYSTEM_NAME STREQUAL "Linux")
+        return()
+    endif()
+
+    execute_process(
+        COMMAND sh -c "echo $PPID; getconf CLK_TCK; cat /proc/$PPID/stat /proc/$PPID/io"
+        OUTPUT_VARIABLE output
+        ERROR_QUIET
+        RESULT_VARIABLE error_code
+    )
+    if(error_code OR NOT output MATCHES "^([0-9]+)\n([0-9]+)\n.*write_bytes")
+        return()
+    endif()
+    set_property(GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_PID "${CMAKE_MATCH_1}")
+    set_property(GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_CLK_TCK "${CMAKE_MATCH_2}")
+
+    find_program(Z_VCPKG_RESOURCE_USAGE_TIME NAMES time PATHS /usr/bin /bin NO_DEFAULT_PATH)
+    if(Z_VCPKG_RESOURCE_USAGE_TIME)
+        execute_process(
+            COMMAND "${Z_VCPKG_RESOURCE_USAGE_TIME}" --version
+            OUTPUT_VARIABLE output
+            ERROR_VARIABLE output
+        )
+        if(NOT output MATCHES "GNU")
+            set(Z_VCPKG_RESOURCE_USAGE_TIME "" CACHE INTERNAL "" FORCE)
+        endif()
+    endif()
+endfunction()
+
+# Sets out_var to "<user ms>;<system ms>;<read bytes>;<written bytes>" of the children of this process.
+function(z_vcpkg_resource_usage_read_counters out_var)
+    get_property(pid GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_PID)
+    get_property(clk_tck GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_CLK_TCK)
+
+    file(READ "/proc/${pid}/stat" stat)
+    # The name of the executable may contain spaces; the fields are counted after it.
+    string(REGEX REPLACE "^.*\\) " "" stat "${stat}")
+    string(REPLACE " " ";" stat "${stat}")
+    list(GET stat 13 children_user)
+    list(GET stat 14 children_system)
+    math(EXPR user_ms "${children_user} * 1000 / ${clk_tck}")
+    math(EXPR system_ms "${children_system} * 1000 / ${clk_tck}")
+
+    file(READ "/proc/${pid}/io" io)
+    string(REGEX MATCH "\nread_bytes: ([0-9]+)" unused "${io}")
+    set(read_bytes "${CMAKE_MATCH_1}")
+    string(REGEX MATCH "\nwrite_bytes: ([0-9]+)" unused "${io}")
+    set(write_bytes "${CMAKE_MATCH_1}")
+
+    set("${out_var}" "${user_ms};${system_ms};${read_bytes};${write_bytes}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_resource_usage_begin prefix)
+    set("${prefix}_SNAPSHOT" "" PARENT_SCOPE)
+    set("${prefix}_WRAPPER" "" PARENT_SCOPE)
+    z_vcpkg_resource_usage_detect()
+    get_property(pid GLOBAL PROPERTY Z_VCPKG_RESOURCE_USAGE_PID)
+    if(pid STREQUAL "")
+        return()
+    endif()
+
+    z_vcpkg_resource_usage_read_counters(snapshot)
+    set("${prefix}_SNAPSHOT" "${snapshot}" PARENT_SCOPE)
+    if(Z_VCPKG_RESOURCE_USAGE_TIME)
+        string(RANDOM LENGTH 8 suffix)
+        set(rss_file "${CURRENT_BUILDTREES_DIR}/resource-usage-${suffix}.tmp")
+        file(REMOVE "${rss_file}")
+        set("${prefix}_RSS_FILE" "${rss_file}" PARENT_SCOPE)
+        set("${prefix}_WRAPPER" "${Z_VCPKG_RESOURCE_USAGE_TIME}" -a -o "${rss_file}" -f "peak-rss %M" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(z_vcpkg_resource_usage_end prefix)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "" "LOGNAME;WORKING_DIRECTORY;RETRIES" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_resource_usage_end was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if("${${prefix}_SNAPSHOT}" STREQUAL "")
+        return()
+    endif()
+    if(NOT DEFINED arg_RETRIES)
+        set(arg_RETRIES 0)
+    endif()
+
+    z_vcpkg_resource_usage_read_counters(counters)
+    set(deltas "")
+    foreach(index RANGE 3)
+        list(GET counters ${index} after)
+        list(GET ${prefix}_SNAPSHOT ${index} before)
+        math(EXPR delta "${after} - ${before}")
+        list(APPEND deltas "${delta}")
+    endforeach()
+    list(JOIN deltas "\t" deltas)
+
+    set(peak_rss "-")
+    if(DEFINED ${prefix}_RSS_FILE AND EXISTS "${${prefix}_RSS_FILE}")
+        file(STRINGS "${${prefix}_RSS_FILE}" rss_lines REGEX "^peak-rss [0-9]+$")
+        file(REMOVE "${${prefix}_RSS_FILE}")
+        foreach(line IN LISTS rss_lines)
+            string(REPLACE "peak-rss " "" rss "${line}")
+            if(peak_rss STREQUAL "-" OR rss GREATER peak_rss)
+                set(peak_rss "${rss}")
+            endif()
+        endforeach()
+    endif()
+
+    set(config "other")
+    if(arg_LOGNAME MATCHES "-(dbg|rel)$")
+        set(config "${CMAKE_MATCH_1}")
+    elseif(arg_WORKING_DIRECTORY MATCHES "-(dbg|rel)/*$")
+        set(config "${CMAKE_MATCH_1}")
+    endif()
+
+    file(APPEND "${CURRENT_BUILDTREES_DIR}/resource-usage-${TARGET_TRIPLET}.log"
+        "${config}\t${deltas}\t${peak_rss}\t${arg_RETRIES}\t${arg_LOGNAME}\n"
+    )
+endfunction()
+
+function(z_vcpkg_resource_usage_format_ms out_var ms)
+    math(EXPR seconds "${ms} / 1000")
+    math(EXPR hundredths "(${ms} % 1000) / 10")
+    if(hundredths LESS "10")
+        set(hundredths "0${hundredths}")
+    endif()
+    set("${out_var}" "${seconds}.${hundredths}s" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_resource_usage_summarize out_var)
+    set("${out_var}" "" PARENT_SCOPE)
+    set(log "${CURRENT_BUILDTREES_DIR}/resource-usage-${TARGET_TRIPLET}.log")
+    if(NOT EXISTS "${log}")
+        return()
+    endif()
+
+    file(STRINGS "${log}" records)
+    set(configs "")
+    foreach(record IN LISTS records)
+        string(REPLACE "\t" ";" record "${record}")
+        list(LENGTH record length)
+        if(length LESS "8")
+            continue()
+        endif()
+        list(GET record 0 config)
+        list(FIND configs "${config}" index)
+        if(index EQUAL "-1")
+            list(APPEND configs "${config}")
+            foreach(field IN ITEMS commands user system read write retries)
+                set(${config}_${field} 0)
+            endforeach()
+            set(${config}_peak_rss "-")
+        endif()
+        math(EXPR ${config}_commands "${${config}_commands} + 1")
+        list(GET record 1 user)
+        list(GET record 2 system)
+        list(GET record 3 read)
+        list(GET record 4 write)
+        list(GET record 5 peak_rss)
+        list(GET record 6 retries)
+        foreach(field IN ITEMS user system read write retries)
+            math(EXPR ${config}_${field} "${${config}_${field}} + ${${field}}")
+        endforeach()
+        if(NOT peak_rss STREQUAL "-" AND ("${${config}_peak_rss}" STREQUAL "-" OR peak_rss GREATER "${${config}_peak_rss}"))
+            set(${config}_peak_rss "${peak_rss}")
+        endif()
+    endforeach()
+
+    set(summary "")
+    foreach(config IN LISTS configs)
+        z_vcpkg_resource_usage_format_ms(user "${${config}_user}")
+        z_vcpkg_resource_usage_format_ms(system "${${config}_system}")
+        set(peak_rss "${${config}_peak_rss}")
+        if(NOT peak_rss STREQUAL "-")
+            set(peak_rss "${peak_rss}KiB")
+        endif()
+        string(APPEND summary
+            "ResourceUsage-${config}: Commands=${${config}_commands}, UserCPU=${user}, SystemCPU=${system}, "
+            "PeakRSS=${peak_rss}, ReadBytes=${${config}_read}, WrittenBytes=${${config}_write}, "
+            "OutOfMemoryRetries=${${config}_retries}\n"
+        )
+    endforeach()
+    set("${out_var}" "${summary}" PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,137 @@
+#[===[.md:
+# z_vcpkg_source_cache
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Keep extracted and patched source trees in a content-addressed cache.
+
+```cmake
+z_vcpkg_source_cache_restore(<out-var>
+    KEY <key>
+    DESTINATION </path/to/sources>
+)
+z_vcpkg_source_cache_store(
+    KEY <key>
+    SOURCE </path/to/sources>
+)
+```
+
+The cache is enabled when the triplet sets `VCPKG_SOURCE_CACHE` to a true value,
+or, if the triplet does not set it, when the environment variable of the same name is true.
+Entries are stored below `VCPKG_SOURCE_CACHE_DIR` (triplet or environment),
+which defaults to `${DOWNLOADS}/source-cache`.
+`<key>` must identify the contents of the tree completely,
+for example the hash of the archive and of all the patches applied to it.
+
+`z_vcpkg_source_cache_restore` sets `<out-var>` to `ON` and creates `DESTINATION`
+as a copy of the cache entry if there is one; otherwise it sets `<out-var>` to `OFF`.
+`z_vcpkg_source_cache_store` adds a copy of `SOURCE` to the cache,
+unless an entry for `<key>` already exists.
+If the cache is not enabled, both functions do nothing, and `<out-var>` is set to `OFF`.
+
+Copies are made with reflinks (`cp --reflink=auto` on Linux, `cp -c` on macOS),
+so that they share storage with the cache on filesystems which support it
+while remaining independent copies: a port that edits its sources cannot modify the cache.
+On other filesystems and on Windows, the files are copied.
+
+Entries are added under a temporary name and then renamed,
+so that concurrent builds never see a partially written entry.
+The cache directory may be deleted at any time.
+#]===]
+
+function(z_vcpkg_source_cache_get_dir out_var)
+    if(NOT DEFINED VCPKG_SOURCE_CACHE AND DEFINED ENV{VCPKG_SOURCE_CACHE})
+        set(VCPKG_SOURCE_CACHE "$ENV{VCPKG_SOURCE_CACHE}")
+    endif()
+    if(NOT DEFINED VCPKG_SOURCE_CACHE_DIR AND DEFINED ENV{VCPKG_SOURCE_CACHE_DIR})
+        set(VCPKG_SOURCE_CACHE_DIR "$ENV{VCPKG_SOURCE_CACHE_DIR}")
+    endif()
+    if(NOT VCPKG_SOURCE_CACHE)
+        set("${out_var}" "" PARENT_SCOPE)
+        return()
+    endif()
+    if(NOT VCPKG_SOURCE_CACHE_DIR)
+        set(VCPKG_SOURCE_CACHE_DIR "${DOWNLOADS}/source-cache")
+    endif()
+    file(TO_CMAKE_PATH "${VCPKG_SOURCE_CACHE_DIR}" cache_dir)
+    set("${out_var}" "${cache_dir}" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_source_cache_clone from to)
+    get_filename_component(to_parent "${to}" DIRECTORY)
+    file(MAKE_DIRECTORY "${to_parent}")
+
+    if(CMAKE_HOST_APPLE)
+        execute_process(
+            COMMAND cp -c -R -p "${from}" "${to}"
+            OUTPUT_QUIET ERROR_QUIET
+            RESULT_VARIABLE error_code
+        )
+    elseif(CMAKE_HOST_UNIX)
+        execute_process(
+            COMMAND cp -a --reflink=auto "${from}" "${to}"
+            OUTPUT_QUIET ERROR_QUIET
+            RESULT_VARIABLE error_code
+        )
+    else()
+        set(error_code 1)
+    endif()
+
+    if(error_code)
+        file(REMOVE_RECURSE "${to}")
+        file(MAKE_DIRECTORY "${to}")
+        file(COPY "${from}/" DESTINATION "${to}")
+    endif()
+endfunction()
+
+function(z_vcpkg_source_cache_restore out_var)
+    cmake_parse_arguments(PARSE_ARGV 1 "arg" "" "KEY;DESTINATION" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_source_cache_restore was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    foreach(required_arg IN ITEMS KEY DESTINATION)
+        if(NOT DEFINED arg_${required_arg})
+            message(FATAL_ERROR "internal error: z_vcpkg_source_cache_restore requires ${required_arg}")
+        endif()
+    endforeach()
+
+    set("${out_var}" OFF PARENT_SCOPE)
+    z_vcpkg_source_cache_get_dir(cache_dir)
+    if(cache_dir STREQUAL "" OR NOT IS_DIRECTORY "${cache_dir}/${arg_KEY}")
+        return()
+    endif()
+
+    message(STATUS "Restoring sources from ${cache_dir}/${arg_KEY}")
+    set(temp_dir "${arg_DESTINATION}.tmp")
+    file(REMOVE_RECURSE "${temp_dir}")
+    z_vcpkg_source_cache_clone("${cache_dir}/${arg_KEY}" "${temp_dir}")
+    file(RENAME "${temp_dir}" "${arg_DESTINATION}")
+    set("${out_var}" ON PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_source_cache_store)
+    cmake_parse_arguments(PARSE_ARGV 0 "arg" "" "KEY;SOURCE" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_source_cache_store was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    foreach(required_arg IN ITEMS KEY SOURCE)
+        if(NOT DEFINED arg_${required_arg})
+            message(FATAL_ERROR "internal error: z_vcpkg_source_cache_store requires ${required_arg}")
+        endif()
+    endforeach()
+
+    z_vcpkg_source_cache_get_dir(cache_dir)
+    if(cache_dir STREQUAL "" OR IS_DIRECTORY "${cache_dir}/${arg_KEY}")
+        return()
+    endif()
+
+    string(RANDOM LENGTH 8 suffix)
+    set(temp_dir "${cache_dir}/${arg_KEY}.${suffix}.tmp")
+    z_vcpkg_source_cache_clone("${arg_SOURCE}" "${temp_dir}")
+    # Another build may have added the same entry in the meantime; both copies are identical.
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" -E rename "${temp_dir}" "${cache_dir}/${arg_KEY}"
+        OUTPUT_QUIET ERROR_QUIET
+    )
+    file(REMOVE_RECURSE "${temp_dir}")
+endfunction()
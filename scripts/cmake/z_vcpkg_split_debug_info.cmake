@@ -0,0 +1,83 @@
+#[===[.md:
+# z_vcpkg_split_debug_info
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Move the debug information of the binaries of a port into separate files.
+
+```cmake
+z_vcpkg_split_debug_info()
+```
+
+If the triplet sets `VCPKG_SPLIT_DEBUG_INFO` for a Linux target, `z_vcpkg_split_debug_info` takes every
+ELF executable and shared library in `${CURRENT_PACKAGES_DIR}` which contains debug information,
+copies the debug information to a file below `${CURRENT_PACKAGES_DIR}/debug-symbols`
+with `objcopy --only-keep-debug`, and removes it from the binary with `objcopy --strip-debug`,
+which also adds a `.gnu_debuglink` section naming the separate file.
+
+A binary which has a build ID gets its debug information in `debug-symbols/.build-id/<xx>/<rest>.debug`,
+the layout which gdb, lldb and debuginfod servers look up.
+Other binaries get it in `debug-symbols/<path of the binary>.debug`.
+
+If the triplet sets `VCPKG_DEBUG_INFO_COMPRESSION` to `zlib` or `zstd`, the debug information is compressed
+with `--compress-debug-sections`. `zstd` requires binutils 2.40 or later.
+#]===]
+
+function(z_vcpkg_split_debug_info)
+    if(NOT VCPKG_SPLIT_DEBUG_INFO OR NOT VCPKG_TARGET_IS_LINUX OR NOT EXISTS "${CURRENT_PACKAGES_DIR}")
+        return()
+    endif()
+    set(compress_option "")
+    if(VCPKG_DEBUG_INFO_COMPRESSION)
+        if(NOT VCPKG_DEBUG_INFO_COMPRESSION MATCHES "^(zlib|zstd)$")
+            message(FATAL_ERROR "VCPKG_DEBUG_INFO_COMPRESSION must be zlib or zstd; got '${VCPKG_DEBUG_INFO_COMPRESSION}'.")
+        endif()
+        set(compress_option "--compress-debug-sections=${VCPKG_DEBUG_INFO_COMPRESSION}")
+    endif()
+    find_program(Z_VCPKG_OBJCOPY NAMES objcopy llvm-objcopy)
+    find_program(Z_VCPKG_READELF NAMES readelf llvm-readelf)
+    if(NOT Z_VCPKG_OBJCOPY OR NOT Z_VCPKG_READELF)
+        message(FATAL_ERROR "VCPKG_SPLIT_DEBUG_INFO requires objcopy and readelf, which could not be found.")
+    endif()
+
+    z_vcpkg_find_elf_binaries(binaries "${CURRENT_PACKAGES_DIR}")
+    set(symbols_dir "${CURRENT_PACKAGES_DIR}/debug-symbols")
+    set(count 0)
+    foreach(binary IN LISTS binaries)
+        file(RELATIVE_PATH relative "${CURRENT_PACKAGES_DIR}" "${binary}")
+        if(relative MATCHES "^debug-symbols/")
+            continue()
+        endif()
+        execute_process(
+            COMMAND "${Z_VCPKG_READELF}" -W -S -n "${binary}"
+            OUTPUT_VARIABLE output
+            ERROR_QUIET
+        )
+        if(NOT output MATCHES "\\.debug_info")
+            continue()
+        endif()
+        if(output MATCHES "Build ID: ([0-9a-f][0-9a-f])([0-9a-f]+)")
+            set(debug_file "${symbols_dir}/.build-id/${CMAKE_MATCH_1}/${CMAKE_MATCH_2}.debug")
+        else()
+            set(debug_file "${symbols_dir}/${relative}.debug")
+        endif()
+        get_filename_component(debug_dir "${debug_file}" DIRECTORY)
+        file(MAKE_DIRECTORY "${debug_dir}")
+
+        vcpkg_execute_required_process(
+            COMMAND "${Z_VCPKG_OBJCOPY}" --only-keep-debug ${compress_option} "${binary}" "${debug_file}"
+            WORKING_DIRECTORY "${CURRENT_PACKAGES_DIR}"
+            LOGNAME "split-debug-info-${TARGET_TRIPLET}"
+        )
+        # The link is looked up relative to the binary by name; the debug file is found through its build ID or path.
+        vcpkg_execute_required_process(
+            COMMAND "${Z_VCPKG_OBJCOPY}" --strip-debug "--add-gnu-debuglink=${debug_file}" "${binary}"
+            WORKING_DIRECTORY "${CURRENT_PACKAGES_DIR}"
+            LOGNAME "split-debug-info-${TARGET_TRIPLET}"
+        )
+        math(EXPR count "${count} + 1")
+    endforeach()
+    if(count GREATER "0")
+        message(STATUS "Moved the debug information of ${count} binaries to ${symbols_dir}")
+    endif()
+endfunction()
@@ -0,0 +1,101 @@
+#[===[.md:
+# z_vcpkg_trace
+
+**Only for internal use in vcpkg helpers. Behavior and arguments will change without notice.**
+
+Record the phases of a port build in a trace file.
+
+```cmake
+z_vcpkg_trace_begin(<name> [CATEGORY <category>])
+z_vcpkg_trace_end(<name> [CATEGORY <category>])
+z_vcpkg_trace_name_thread(<thread> <name>)
+```
+
+`z_vcpkg_trace_begin` and `z_vcpkg_trace_end` append a begin and an end event
+to the file named by `Z_VCPKG_TRACE_FILE`, which `scripts/ports.cmake` sets to
+`${CURRENT_BUILDTREES_DIR}/trace-${TARGET_TRIPLET}.json`.
+Every call to `z_vcpkg_trace_begin` must be matched by a call to `z_vcpkg_trace_end`
+with the same `<name>` on every path out of the helper, including early `return()`s.
+The `<category>` groups related events, for example `download`, `configure` or `build`.
+If `Z_VCPKG_TRACE_FILE` is not set, for example when a helper is used outside of a port build,
+these functions do nothing.
+
+Events are recorded for the thread `Z_VCPKG_TRACE_THREAD`, which is `1` unless set otherwise;
+builds running concurrently use their own threads, which `z_vcpkg_trace_name_thread` names.
+
+The file uses the JSON array form of the
+[Trace Event Format](https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU),
+which can be opened in `chrome://tracing` or in [Perfetto](https://ui.perfetto.dev).
+Since events are appended as they happen, the closing `]` is omitted, as the format allows.
+Timestamps are in microseconds since the Unix epoch, so that the traces of all ports can be merged
+into a single timeline by [`scripts/merge_build_traces.cmake`](../../users/build-traces.md).
+#]===]
+
+function(z_vcpkg_trace_now out_var)
+    # %f (microseconds) requires CMake 3.23.
+    if(CMAKE_VERSION VERSION_LESS "3.23")
+        string(TIMESTAMP seconds "%s" UTC)
+        set("${out_var}" "${seconds}000000" PARENT_SCOPE)
+    else()
+        string(TIMESTAMP now "%s%f" UTC)
+        set("${out_var}" "${now}" PARENT_SCOPE)
+    endif()
+endfunction()
+
+function(z_vcpkg_trace_json_string out_var value)
+    string(REPLACE "\\" "\\\\" value "${value}")
+    string(REPLACE "\"" "\\\"" value "${value}")
+    string(REPLACE "\n" "\\n" value "${value}")
+    set("${out_var}" "\"${value}\"" PARENT_SCOPE)
+endfunction()
+
+function(z_vcpkg_trace_init)
+    z_vcpkg_trace_json_string(process_name "${PORT}:${TARGET_TRIPLET}")
+    file(WRITE "${Z_VCPKG_TRACE_FILE}"
+        "[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":${process_name}}},\n"
+    )
+    z_vcpkg_trace_name_thread(1 "portfile")
+endfunction()
+
+function(z_vcpkg_trace_name_thread thread name)
+    if(NOT DEFINED Z_VCPKG_TRACE_FILE)
+        return()
+    endif()
+    z_vcpkg_trace_json_string(name "${name}")
+    file(APPEND "${Z_VCPKG_TRACE_FILE}"
+        "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":${thread},\"args\":{\"name\":${name}}},\n"
+    )
+endfunction()
+
+function(z_vcpkg_trace_event phase name)
+    cmake_parse_arguments(PARSE_ARGV 2 "arg" "" "CATEGORY" "")
+    if(DEFINED arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "internal error: z_vcpkg_trace_event was passed extra arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if(NOT DEFINED Z_VCPKG_TRACE_FILE)
+        return()
+    endif()
+    if(NOT DEFINED arg_CATEGORY)
+        set(arg_CATEGORY "vcpkg")
+    endif()
+    set(thread "${Z_VCPKG_TRACE_THREAD}")
+    if(thread STREQUAL "")
+        set(thread 1)
+    endif()
+
+    z_vcpkg_trace_now(timestamp)
+    z_vcpkg_trace_json_string(name "${name}")
+    z_vcpkg_trace_json_string(category "${arg_CATEGORY}")
+    file(APPEND "${Z_VCPKG_TRACE_FILE}"
+        "{\"name\":${name},\"cat\":${category},\"ph\":\"${phase}\",\"ts\":${timestamp},\"pid\":1,\"tid\":${thread}},\n"
+    )
+endfunction()
+
+function(z_vcpkg_trace_begin name)
+    z_vcpkg_trace_event(B "${name}" ${ARGN})
+endfunction()
+
+function(z_vcpkg_trace_end name)
+    z_vcpkg_trace_event(E "${name}" ${ARGN})
+endfunction()
@@ -0,0 +1,44 @@
+# Merges the build traces of all ports into a single timeline.
+# See docs/users/build-traces.md.
+#
+# Usage: cmake -DBUILDTREES_DIR=<vcpkg-root>/buildtrees [-DOUTPUT=<file>] -P merge_build_traces.cmake
+
+cmake_minimum_required(VERSION 3.14)
+
+if(NOT DEFINED BUILDTREES_DIR)
+    get_filename_component(BUILDTREES_DIR "${CMAKE_CURRENT_LIST_DIR}/../buildtrees" ABSOLUTE)
+endif()
+file(TO_CMAKE_PATH "${BUILDTREES_DIR}" BUILDTREES_DIR)
+if(NOT DEFINED OUTPUT)
+    set(OUTPUT "${BUILDTREES_DIR}/trace.json")
+endif()
+
+file(GLOB trace_files LIST_DIRECTORIES false "${BUILDTREES_DIR}/*/trace-*.json")
+if(trace_files STREQUAL "")
+    message(FATAL_ERROR "No build traces found in ${BUILDTREES_DIR}.")
+endif()
+
+# Each port is recorded as process 1 of its own trace; give each trace a process of its own.
+set(merged "")
+set(process 0)
+foreach(trace_file IN LISTS trace_files)
+    math(EXPR process "${process} + 1")
+    file(READ "${trace_file}" contents)
+    string(STRIP "${contents}" contents)
+    string(REGEX REPLACE "^\\[" "" contents "${contents}")
+    string(REGEX REPLACE "\\]$" "" contents "${contents}")
+    string(STRIP "${contents}" contents)
+    string(REGEX REPLACE ",$" "" contents "${contents}")
+    string(REPLACE "\"pid\":1," "\"pid\":${process}," contents "${contents}")
+    if(contents STREQUAL "")
+        continue()
+    endif()
+    if(NOT merged STREQUAL "")
+        string(APPEND merged ",\n")
+    endif()
+    string(APPEND merged "${contents}")
+endforeach()
+
+file(WRITE "${OUTPUT}" "[\n${merged}\n]\n")
+list(LENGTH trace_files trace_count)
+message(STATUS "Merged ${trace_count} build traces into ${OUTPUT}")
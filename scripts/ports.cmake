@@ -84,6 +84,8 @@ if(CMD MATCHES "^BUILD$")
     include("${SCRIPTS}/cmake/vcpkg_common_definitions.cmake")
     include("${SCRIPTS}/cmake/execute_process.cmake")
     include("${SCRIPTS}/cmake/vcpkg_acquire_msys.cmake")
+    include("${SCRIPTS}/cmake/vcpkg_add_find_dependency.cmake")
+    include("${SCRIPTS}/cmake/vcpkg_add_pkgconfig_libs_private.cmake")
     include("${SCRIPTS}/cmake/vcpkg_add_to_path.cmake")
     include("${SCRIPTS}/cmake/vcpkg_apply_patches.cmake")
     include("${SCRIPTS}/cmake/vcpkg_build_cmake.cmake")
@@ -124,6 +126,7 @@ if(CMD MATCHES "^BUILD$")
     include("${SCRIPTS}/cmake/vcpkg_get_windows_sdk.cmake")
     include("${SCRIPTS}/cmake/vcpkg_install_cmake.cmake")
     include("${SCRIPTS}/cmake/vcpkg_install_gn.cmake")
+    include("${SCRIPTS}/cmake/vcpkg_install_headers.cmake")
     include("${SCRIPTS}/cmake/vcpkg_install_make.cmake")
     include("${SCRIPTS}/cmake/vcpkg_install_meson.cmake")
     include("${SCRIPTS}/cmake/vcpkg_install_msbuild.cmake")
@@ -134,9 +137,31 @@ if(CMD MATCHES "^BUILD$")
     include("${SCRIPTS}/cmake/vcpkg_test_cmake.cmake")
 
     include("${SCRIPTS}/cmake/z_vcpkg_apply_patches.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_build_hotspots.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_check_linker.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_compiler_cache.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_concurrent_build.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_find_elf_binaries.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_get_build_jobs.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_get_file_sha512.cmake")
     include("${SCRIPTS}/cmake/z_vcpkg_prettify_command_line.cmake")
-
+    include("${SCRIPTS}/cmake/z_vcpkg_resource_usage.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_source_cache.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_split_debug_info.cmake")
+    include("${SCRIPTS}/cmake/z_vcpkg_trace.cmake")
+
+    set(Z_VCPKG_TRACE_FILE "${CURRENT_BUILDTREES_DIR}/trace-${TARGET_TRIPLET}.json")
+    z_vcpkg_trace_init()
+    z_vcpkg_resource_usage_init()
+    z_vcpkg_trace_begin("${PORT}" CATEGORY port)
+    z_vcpkg_compiler_cache_begin()
+    z_vcpkg_build_hotspots_begin()
     include("${CURRENT_PORT_DIR}/portfile.cmake")
+    z_vcpkg_build_hotspots_end()
+    z_vcpkg_check_linker()
+    z_vcpkg_split_debug_info()
+    z_vcpkg_compiler_cache_end()
+    z_vcpkg_trace_end("${PORT}" CATEGORY port)
     if(DEFINED PORT)
         include("${SCRIPTS}/build_info.cmake")
     endif()
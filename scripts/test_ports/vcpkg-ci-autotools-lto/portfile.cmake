@@ -0,0 +1,19 @@
+set(VCPKG_POLICY_EMPTY_PACKAGE enabled)
+set(VCPKG_BUILD_TYPE release)
+
+if(NOT VCPKG_LTO)
+    message(STATUS "VCPKG_LTO is not set; not testing the archives of LTO objects")
+    return()
+endif()
+
+# autoreconf writes into the source directory.
+set(SOURCE_PATH "${CURRENT_BUILDTREES_DIR}/src/project")
+file(REMOVE_RECURSE "${SOURCE_PATH}")
+file(COPY "${CMAKE_CURRENT_LIST_DIR}/project/" DESTINATION "${SOURCE_PATH}")
+
+vcpkg_configure_make(
+    SOURCE_PATH "${SOURCE_PATH}"
+    AUTOCONFIG
+)
+# Linking lto-main against the static library fails if the archive has no index of the symbols in its LTO objects.
+vcpkg_build_make()
@@ -0,0 +1,4 @@
+int lto_test_square(int value)
+{
+    return value * value;
+}
@@ -0,0 +1,7 @@
+int lto_test_square(int value);
+
+int main(int argc, char** argv)
+{
+    (void)argv;
+    return lto_test_square(argc) == 1 ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+set(VCPKG_POLICY_EMPTY_PACKAGE enabled)
+set(VCPKG_BUILD_TYPE release)
+
+vcpkg_cmake_configure(
+    SOURCE_PATH "${CMAKE_CURRENT_LIST_DIR}/project"
+)
+vcpkg_cmake_build()
+
+if(NOT TARGET_TRIPLET STREQUAL HOST_TRIPLET)
+    message(STATUS "Not running zstd-scaling when cross-compiling")
+    return()
+endif()
+
+# VCPKG_CONCURRENCY honors the CPU quota of the build; the number of cores of the host may not.
+if(VCPKG_CONCURRENCY MATCHES "^[0-9]+$" AND VCPKG_CONCURRENCY GREATER "0")
+    set(workers "${VCPKG_CONCURRENCY}")
+else()
+    cmake_host_system_information(RESULT workers QUERY NUMBER_OF_LOGICAL_CORES)
+endif()
+if(workers GREATER "4")
+    set(workers 4)
+endif()
+find_program(zstd_scaling NAMES zstd-scaling
+    PATHS "${CURRENT_BUILDTREES_DIR}/${TARGET_TRIPLET}-rel"
+    PATH_SUFFIXES Release
+    NO_DEFAULT_PATH
+    REQUIRED
+)
+vcpkg_execute_required_process(
+    COMMAND "${zstd_scaling}" ${workers}
+    WORKING_DIRECTORY "${CURRENT_BUILDTREES_DIR}"
+    LOGNAME "zstd-scaling-${TARGET_TRIPLET}"
+)
@@ -0,0 +1,127 @@
+/* Compresses the same buffer with one worker and with several, and fails unless
+ * the library was built with worker-thread support, the output of several workers
+ * decompresses to the input, and, given at least two CPUs, the workers make it faster. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <zstd.h>
+
+#define INPUT_SIZE (64u * 1024u * 1024u)
+#define RUNS 3
+
+static double now(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Text-like data made of words from a small dictionary, so that it compresses like real input. */
+static void fill(char* buffer, size_t size)
+{
+    static const char* const words[] = {
+        "alpha ", "bravo ", "charlie ", "delta ", "echo ", "foxtrot ", "golf ", "hotel ",
+        "india ", "juliett ", "kilo ", "lima ", "mike ", "november ", "oscar ", "papa ",
+    };
+    unsigned state = 12345u;
+    size_t pos = 0;
+    while (pos < size) {
+        const char* word;
+        size_t length;
+        state = state * 1103515245u + 12345u;
+        word = words[(state >> 16) % 16];
+        length = strlen(word);
+        if (length > size - pos) length = size - pos;
+        memcpy(buffer + pos, word, length);
+        pos += length;
+    }
+}
+
+/* Returns the best time of RUNS compressions of the input, or a negative value on error.
+ * The size of the compressed output is stored in *compressed_size. */
+static double compress_time(ZSTD_CCtx* cctx, int workers, const char* input, void* output, size_t capacity,
+                            size_t* compressed_size)
+{
+    double best = -1.0;
+    int run;
+    size_t result = ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, workers);
+    if (ZSTD_isError(result)) {
+        fprintf(stderr, "Setting %d workers failed: %s\n", workers, ZSTD_getErrorName(result));
+        return -1.0;
+    }
+    for (run = 0; run < RUNS; ++run) {
+        double start = now();
+        double elapsed;
+        result = ZSTD_compress2(cctx, output, capacity, input, INPUT_SIZE);
+        elapsed = now() - start;
+        if (ZSTD_isError(result)) {
+            fprintf(stderr, "Compression with %d workers failed: %s\n", workers, ZSTD_getErrorName(result));
+            return -1.0;
+        }
+        if (best < 0.0 || elapsed < best) best = elapsed;
+        *compressed_size = result;
+    }
+    printf("%d worker(s): %.3f s\n", workers, best);
+    return best;
+}
+
+/* Returns whether the compressed data decompresses to the input. */
+static int round_trip(const char* input, const void* compressed, size_t compressed_size)
+{
+    char* decompressed = malloc(INPUT_SIZE);
+    size_t result;
+    int equal;
+    if (!decompressed) {
+        fprintf(stderr, "Out of memory\n");
+        return 0;
+    }
+    result = ZSTD_decompress(decompressed, INPUT_SIZE, compressed, compressed_size);
+    if (ZSTD_isError(result)) {
+        fprintf(stderr, "Decompression failed: %s\n", ZSTD_getErrorName(result));
+        equal = 0;
+    } else {
+        equal = result == INPUT_SIZE && memcmp(decompressed, input, INPUT_SIZE) == 0;
+        if (!equal) fprintf(stderr, "The decompressed data differs from the input\n");
+    }
+    free(decompressed);
+    return equal;
+}
+
+int main(int argc, char** argv)
+{
+    int workers = argc > 1 ? atoi(argv[1]) : 4;
+    size_t capacity = ZSTD_compressBound(INPUT_SIZE);
+    char* input = malloc(INPUT_SIZE);
+    void* output = malloc(capacity);
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    size_t compressed_size = 0;
+    double single;
+    double multi;
+    int status = EXIT_SUCCESS;
+
+    if (!input || !output || !cctx) {
+        fprintf(stderr, "Out of memory\n");
+        return EXIT_FAILURE;
+    }
+    fill(input, INPUT_SIZE);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, 3);
+
+    /* nbWorkers == 1 already compresses in a worker thread, so it is the single-threaded baseline. */
+    single = compress_time(cctx, 1, input, output, capacity, &compressed_size);
+    multi = compress_time(cctx, workers, input, output, capacity, &compressed_size);
+    if (single < 0.0 || multi < 0.0 || !round_trip(input, output, compressed_size)) {
+        status = EXIT_FAILURE;
+    } else if (workers < 2) {
+        printf("Only one CPU is available; not checking the scaling\n");
+    } else if (multi * 1.25 > single) {
+        fprintf(stderr, "%d workers are not faster than one worker\n", workers);
+        status = EXIT_FAILURE;
+    }
+
+    ZSTD_freeCCtx(cctx);
+    free(output);
+    free(input);
+    return status;
+}
@@ -34,6 +34,42 @@ elseif(VCPKG_TARGET_ARCHITECTURE STREQUAL "arm64")
     endif()
 endif()
 
+if(VCPKG_TARGET_ISA_LEVEL)
+    if(NOT VCPKG_TARGET_ARCHITECTURE STREQUAL "x64" OR NOT VCPKG_TARGET_ISA_LEVEL MATCHES "^v[234]$")
+        message(FATAL_ERROR "VCPKG_TARGET_ISA_LEVEL must be v2, v3 or v4 on x64; got '${VCPKG_TARGET_ISA_LEVEL}' on ${VCPKG_TARGET_ARCHITECTURE}.")
+    endif()
+    # Requires GCC 11 or clang 12.
+    string(APPEND VCPKG_C_FLAGS " -march=x86-64-${VCPKG_TARGET_ISA_LEVEL}")
+    string(APPEND VCPKG_CXX_FLAGS " -march=x86-64-${VCPKG_TARGET_ISA_LEVEL}")
+endif()
+
+if(VCPKG_LINKER)
+    if(NOT VCPKG_LINKER MATCHES "^(bfd|gold|lld|mold)$")
+        message(FATAL_ERROR "VCPKG_LINKER must be bfd, gold, lld or mold; got '${VCPKG_LINKER}'.")
+    endif()
+    find_program(VCPKG_LINKER_PROGRAM NAMES "ld.${VCPKG_LINKER}" "${VCPKG_LINKER}")
+    if(NOT VCPKG_LINKER_PROGRAM)
+        message(FATAL_ERROR "VCPKG_LINKER is set to ${VCPKG_LINKER}, but ld.${VCPKG_LINKER} could not be found.")
+    endif()
+    # Not used by the compiler driver, but reported to the make and meson helpers.
+    set(CMAKE_LINKER "${VCPKG_LINKER_PROGRAM}" CACHE FILEPATH "")
+    # -fuse-ld=mold requires GCC 12.1 or clang.
+    string(APPEND VCPKG_LINKER_FLAGS " -fuse-ld=${VCPKG_LINKER}")
+endif()
+
+if(VCPKG_COMPILER_CACHE_LAUNCHER)
+    set(CMAKE_C_COMPILER_LAUNCHER "${VCPKG_COMPILER_CACHE_LAUNCHER}" CACHE STRING "")
+    set(CMAKE_CXX_COMPILER_LAUNCHER "${VCPKG_COMPILER_CACHE_LAUNCHER}" CACHE STRING "")
+endif()
+
+if(VCPKG_LTO)
+    if(NOT VCPKG_LTO MATCHES "^(thin|full)$")
+        message(FATAL_ERROR "VCPKG_LTO must be thin, full or off; got '${VCPKG_LTO}'.")
+    endif()
+    # The flags depend on the compiler, which is only known once the project enables its languages.
+    set(CMAKE_USER_MAKE_RULES_OVERRIDE "${CMAKE_CURRENT_LIST_DIR}/lto-rules.cmake")
+endif()
+
 get_property( _CMAKE_IN_TRY_COMPILE GLOBAL PROPERTY IN_TRY_COMPILE )
 if(NOT _CMAKE_IN_TRY_COMPILE)
     string(APPEND CMAKE_C_FLAGS_INIT " -fPIC ${VCPKG_C_FLAGS} ")
@@ -0,0 +1,47 @@
+# Included through CMAKE_USER_MAKE_RULES_OVERRIDE by the toolchains when VCPKG_LTO is set.
+# This runs after each language has been enabled, so the flags can be chosen for the compiler in use.
+get_property(_VCPKG_IN_TRY_COMPILE GLOBAL PROPERTY IN_TRY_COMPILE)
+foreach(_VCPKG_LTO_LANG IN ITEMS C CXX)
+    if(_VCPKG_IN_TRY_COMPILE OR NOT DEFINED CMAKE_${_VCPKG_LTO_LANG}_COMPILER_ID OR DEFINED _VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG})
+        continue()
+    endif()
+
+    if(CMAKE_${_VCPKG_LTO_LANG}_COMPILER_ID STREQUAL "GNU")
+        # GCC always partitions the program for a parallel link; there is no separate thin mode.
+        if(CMAKE_${_VCPKG_LTO_LANG}_COMPILER_VERSION VERSION_LESS "10")
+            set(_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG} "-flto")
+        else()
+            set(_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG} "-flto=auto")
+        endif()
+        # Fat objects keep static libraries usable by consumers which do not link with -flto.
+        string(APPEND CMAKE_${_VCPKG_LTO_LANG}_FLAGS_RELEASE_INIT " ${_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG}} -ffat-lto-objects")
+    elseif(CMAKE_${_VCPKG_LTO_LANG}_COMPILER_ID STREQUAL "Clang")
+        if(VCPKG_LTO STREQUAL "thin")
+            set(_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG} "-flto=thin")
+        else()
+            set(_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG} "-flto")
+        endif()
+        string(APPEND CMAKE_${_VCPKG_LTO_LANG}_FLAGS_RELEASE_INIT " ${_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG}}")
+    else()
+        set(_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG} "")
+        message(WARNING "VCPKG_LTO is not supported for the ${CMAKE_${_VCPKG_LTO_LANG}_COMPILER_ID} compiler and will be ignored.")
+        continue()
+    endif()
+
+    # The linker flags are initialized with the first language only.
+    if(NOT DEFINED _VCPKG_LTO_LINKER_FLAGS)
+        set(_VCPKG_LTO_LINKER_FLAGS "${_VCPKG_LTO_FLAGS_${_VCPKG_LTO_LANG}}")
+        string(APPEND CMAKE_SHARED_LINKER_FLAGS_RELEASE_INIT " ${_VCPKG_LTO_LINKER_FLAGS}")
+        string(APPEND CMAKE_MODULE_LINKER_FLAGS_RELEASE_INIT " ${_VCPKG_LTO_LINKER_FLAGS}")
+        string(APPEND CMAKE_EXE_LINKER_FLAGS_RELEASE_INIT " ${_VCPKG_LTO_LINKER_FLAGS}")
+    endif()
+
+    # Archives of LTO objects need an index of the symbols in the intermediate code,
+    # which only the wrappers of the compiler (gcc-ar, llvm-ar) can write.
+    if(CMAKE_${_VCPKG_LTO_LANG}_COMPILER_AR AND CMAKE_${_VCPKG_LTO_LANG}_COMPILER_RANLIB)
+        set(CMAKE_AR "${CMAKE_${_VCPKG_LTO_LANG}_COMPILER_AR}" CACHE FILEPATH "Archiver" FORCE)
+        set(CMAKE_RANLIB "${CMAKE_${_VCPKG_LTO_LANG}_COMPILER_RANLIB}" CACHE FILEPATH "Ranlib" FORCE)
+    else()
+        message(WARNING "Could not find the archiver for LTO objects of the ${CMAKE_${_VCPKG_LTO_LANG}_COMPILER_ID} compiler; using ${CMAKE_AR}.")
+    endif()
+endforeach()
@@ -5,6 +5,7 @@ function(vcpkg_get_tags PORT FEATURES VCPKG_TRIPLET_ID VCPKG_ABI_SETTINGS_FILE)
     # GUID used as a flag - "cut here line"
     message("c35112b6-d1ba-415b-aa5d-81de856ef8eb
 VCPKG_TARGET_ARCHITECTURE=${VCPKG_TARGET_ARCHITECTURE}
+VCPKG_TARGET_ISA_LEVEL=${VCPKG_TARGET_ISA_LEVEL}
 VCPKG_CMAKE_SYSTEM_NAME=${VCPKG_CMAKE_SYSTEM_NAME}
 VCPKG_CMAKE_SYSTEM_VERSION=${VCPKG_CMAKE_SYSTEM_VERSION}
 VCPKG_PLATFORM_TOOLSET=${VCPKG_PLATFORM_TOOLSET}